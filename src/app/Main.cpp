@@ -18,13 +18,45 @@
 #include "Config.h"
 #include "Timer.h"
 #include "Errors.h"
-#include "Elevator.h"
+#include "DemandModel.h"
+#include "BuildingHost.h"
+#include "GroupController.h"
 #include "Log.h"
+#include "MotionProfile.h"
+#include "PassengerTrace.h"
+#include "SimulationBatch.h"
+#include <algorithm>
+#include <atomic>
 #include <csignal>
+#include <functional>
 #include <thread>
 
+#ifndef _WARHEAD_CONTROLLER_CONFIG
+#define _WARHEAD_CONTROLLER_CONFIG "WarheadController.conf"
+#endif
+
+// Exit code for main function
+enum ShutdownExitCode : uint8
+{
+    SHUTDOWN_EXIT_CODE,
+    ERROR_EXIT_CODE
+};
+
+namespace
+{
+    std::atomic<bool> _stopped{};
+    std::atomic<uint8> _exitCode{ SHUTDOWN_EXIT_CODE };
+
+    // Log passenger stats on next update
+    std::atomic<bool> _reportStats{};
+}
+
 void TerminateHandler(int sigval);
-void ElevatorUpdateLoop();
+void ReportStatsHandler(int sigval);
+void UpdateLoop(std::function<void(Milliseconds)> const& update, std::function<void()> const& reportStats);
+void RunGroup(uint32 carCount);
+void RunHost(uint32 buildingCount, uint32 carCount);
+void RunSimulation();
 
 /// Launch the server
 int main()
@@ -33,28 +65,220 @@ int main()
     signal(SIGINT, &TerminateHandler);
     signal(SIGABRT, &Warhead::AbortHandler);
 
+#if WARHEAD_PLATFORM != WARHEAD_PLATFORM_WINDOWS
+    // kill -USR1 <pid> logs passenger stats
+    signal(SIGUSR1, &ReportStatsHandler);
+#endif
+
     // Use only console logger
     sLog->UsingDefaultLogs();
 
+    sConfigMgr->Configure(sConfigMgr->GetConfigPath() + _WARHEAD_CONTROLLER_CONFIG);
+
+    if (!sConfigMgr->LoadAppConfigs())
+        LOG_WARN("server.loading", "Can't load config file '{}'. Use default options", sConfigMgr->GetFilename());
+
+    // Run event driven simulation in virtual time instead of real time elevator
+    if (sConfigMgr->GetOption<bool>("Simulation.Enable", false))
+    {
+        RunSimulation();
+        return 0;
+    }
+
+    auto carCount = std::clamp<uint32>(sConfigMgr->GetOption<uint32>("Building.CarCount", 1), 1, ElevatorGroup::MAX_CAR_COUNT);
+
+    // Control many buildings in one process
+    auto buildingCount = sConfigMgr->GetOption<uint32>("Host.BuildingCount", 1);
+    if (buildingCount > 1)
+    {
+        RunHost(buildingCount, carCount);
+        return _exitCode;
+    }
+
+    // Run every car of group as actor on own thread
+    if (carCount > 1)
+    {
+        RunGroup(carCount);
+        return _exitCode;
+    }
+
     // Configure elevator
-    sElevator->Start();
+    Elevator elevator(BuildingGeometry::LoadFromConfig());
+    elevator.SetDispatchPolicy(DispatchPolicyRegistry::LoadFromConfig());
+    elevator.SetCapacity(CarCapacity::LoadFromConfig());
+    elevator.SetDoubleDeck(sConfigMgr->GetOption<bool>("Building.DoubleDeck", false));
+
+    // Fly between floors by kinematic limits of car
+    FlightTimeTable flightTimes(elevator.GetGeometry(), MotionProfile::LoadFromConfig());
+    elevator.SetFlightTimes(&flightTimes);
+
+    // Learn hall calls and park idle elevator where next passenger most likely comes from
+    DemandModel demandModel(elevator.GetGeometry(), DemandModelConfig::LoadFromConfig());
+    if (sConfigMgr->GetOption<bool>("Dispatch.Parking.Enable", false))
+        elevator.SetDemandModel(&demandModel);
+
+    // Record all passengers for replay in simulation
+    PassengerTraceWriter traceWriter;
+    auto recordFile = sConfigMgr->GetOption<std::string>("Trace.RecordFile", "");
+    if (!recordFile.empty() && traceWriter.Open(recordFile))
+        elevator.SetTraceWriter(&traceWriter);
+
+    elevator.Start();
 
     // Start main loop
-    ElevatorUpdateLoop();
+    UpdateLoop([&elevator](Milliseconds diff) { elevator.Update(diff); }, [&elevator]() { elevator.GetStats().LogReport(elevator.GetGeometry()); });
+
+    elevator.GetStats().LogReport(elevator.GetGeometry());
+    LOG_INFO("elevator", "> Drive energy: {:.3f} kWh", elevator.GetEnergy() / 3.6e6);
 
     LOG_INFO("elevator", "Halting process...");
 
     // 0 - normal shutdown
     // 1 - shutdown at error
-    return 0;
+    return _exitCode;
+}
+
+void RunGroup(uint32 carCount)
+{
+    ElevatorGroup group(carCount, BuildingGeometry::LoadFromConfig());
+    group.SetDispatchPolicy(DispatchPolicyRegistry::LoadFromConfig());
+    group.SetCapacity(CarCapacity::LoadFromConfig());
+    group.SetDoubleDeck(sConfigMgr->GetOption<bool>("Building.DoubleDeck", false));
+    group.SetReallocation(CallAllocatorConfig::LoadFromConfig());
+
+    FlightTimeTable flightTimes(group.GetGeometry(), MotionProfile::LoadFromConfig());
+    group.SetEtaTiming(flightTimes.GetEtaTiming());
+    for (std::size_t i{}; i < group.GetCarCount(); i++)
+        group.GetCar(i)->SetFlightTimes(&flightTimes);
+
+    // Dispatcher sees every hall call. It learns demand for parking of idle cars
+    DemandModel demandModel(group.GetGeometry(), DemandModelConfig::LoadFromConfig());
+    bool isParkingEnabled = sConfigMgr->GetOption<bool>("Dispatch.Parking.Enable", false);
+
+    // Record all passengers for replay in simulation
+    PassengerTraceWriter traceWriter;
+    auto recordFile = sConfigMgr->GetOption<std::string>("Trace.RecordFile", "");
+    bool isTraceEnabled = !recordFile.empty() && traceWriter.Open(recordFile);
+
+    group.Start();
+
+    GroupController controller(group, isParkingEnabled ? &demandModel : nullptr, isTraceEnabled ? &traceWriter : nullptr);
+
+    // Start main loop
+    UpdateLoop([&controller](Milliseconds diff) { controller.Update(diff); }, [&controller, &group]()
+    {
+        // Stats are read when all cars are idle
+        controller.Wait();
+        group.GetStats().LogReport(group.GetGeometry());
+    });
+
+    controller.Wait();
+    controller.Stop();
+
+    group.GetStats().LogReport(group.GetGeometry());
+
+    double energy{};
+    for (std::size_t i{}; i < group.GetCarCount(); i++)
+        energy += group.GetCar(i)->GetEnergy();
+
+    LOG_INFO("elevator", "> Drive energy: {:.3f} kWh", energy / 3.6e6);
+
+    if (group.IsReallocationEnabled())
+        LOG_INFO("elevator", "> Hall calls moved by reallocation: {}", group.GetReallocatedCount());
+
+    LOG_INFO("elevator", "Halting process...");
 }
 
-void ElevatorUpdateLoop()
+void RunHost(uint32 buildingCount, uint32 carCount)
+{
+    BuildingHost host(sConfigMgr->GetOption<uint32>("Host.ThreadCount", 0));
+
+    auto geometry = BuildingGeometry::LoadFromConfig();
+    auto policy = DispatchPolicyRegistry::LoadFromConfig();
+    auto capacity = CarCapacity::LoadFromConfig();
+    auto isDoubleDeck = sConfigMgr->GetOption<bool>("Building.DoubleDeck", false);
+
+    // Search runs in building update on host worker, so buildings start no workers of their own
+    auto reallocation = CallAllocatorConfig::LoadFromConfig();
+    reallocation.IsInline = true;
+
+    // Flight times are read only, all buildings share them
+    FlightTimeTable flightTimes(geometry, MotionProfile::LoadFromConfig());
+
+    for (uint32 i{}; i < buildingCount; i++)
+    {
+        auto& group = host.GetBuilding(host.AddBuilding(carCount, geometry));
+        group.SetDispatchPolicy(policy);
+        group.SetCapacity(capacity);
+        group.SetDoubleDeck(isDoubleDeck);
+        group.SetEtaTiming(flightTimes.GetEtaTiming());
+        group.SetReallocation(reallocation);
+
+        for (std::size_t carIndex{}; carIndex < group.GetCarCount(); carIndex++)
+            group.GetCar(carIndex)->SetFlightTimes(&flightTimes);
+
+        group.Start();
+    }
+
+    LOG_INFO("elevator", "Host started {} buildings of {} cars on {} threads", buildingCount, carCount, host.GetThreadCount());
+
+    // Start main loop
+    UpdateLoop([&host](Milliseconds diff) { host.Update(diff); }, [&host, &geometry]()
+    {
+        // Stats are read when no building updates
+        host.Wait();
+        host.GetStats().LogReport(geometry);
+    });
+
+    host.Wait();
+
+    host.GetStats().LogReport(geometry);
+    LOG_INFO("elevator", "> Passengers delivered: {}. Building updates stolen by other workers: {}", host.GetDeliveredCount(), host.GetStealCount());
+    LOG_INFO("elevator", "Halting process...");
+}
+
+void RunSimulation()
+{
+    // Passenger logs are too verbose for simulation
+    sLog->SetLoggerLevel("root", Warhead::LogLevel::Info);
+
+    auto config = SimulationBatchConfig::LoadFromConfig();
+    if (config.RunCount == 1)
+    {
+        Simulation simulation(config.Base);
+        auto report = simulation.Run();
+
+        LOG_INFO("simulation", "> Simulation: {} buildings of {} cars. {} simulated in {}. Speed ratio: {:.0f}x. Events: {}. Passengers arrived: {}, delivered: {}",
+            simulation.GetBuildingCount(), config.Base.CarCount, Warhead::Time::ToTimeString(std::chrono::duration_cast<Microseconds>(report.SimulatedTime)),
+            Warhead::Time::ToTimeString(report.RealTime), report.GetSpeedRatio(), report.EventCount, report.ArrivedCount, report.DeliveredCount);
+
+        LOG_INFO("simulation", "> Drive energy: {:.3f} kWh", report.Energy);
+
+        if (simulation.GetGroup().IsReallocationEnabled())
+            LOG_INFO("simulation", "> Hall calls moved by reallocation: {}", report.ReallocatedCount);
+
+        simulation.GetStats().LogReport(config.Base.Geometry);
+        return;
+    }
+
+    SimulationBatch batch(config);
+    auto report = batch.Run();
+
+    LOG_INFO("simulation", "> Simulation batch: {} runs on {} threads. {} simulated in {}. Speed ratio: {:.0f}x. Events: {}",
+        report.RunCount, report.ThreadCount, Warhead::Time::ToTimeString(std::chrono::duration_cast<Microseconds>(report.SimulatedTime)),
+        Warhead::Time::ToTimeString(report.RealTime), report.GetSpeedRatio(), report.EventCount);
+
+    LOG_INFO("simulation", "> Passengers arrived: {}, delivered: {}. Delivered per run: min {}, max {}, average {:.1f}",
+        report.ArrivedCount, report.DeliveredCount, report.MinDelivered, report.MaxDelivered,
+        static_cast<double>(report.DeliveredCount) / report.RunCount);
+}
+
+void UpdateLoop(std::function<void(Milliseconds)> const& update, std::function<void()> const& reportStats)
 {
     auto realCurrTime = 0ms;
     auto realPrevTime = GetTimeMS();
 
-    while (!Elevator::IsStopped())
+    while (!_stopped)
     {
         realCurrTime = GetTimeMS();
 
@@ -65,8 +289,11 @@ void ElevatorUpdateLoop()
             continue;
         }
 
-        sElevator->Update();
+        update(diff);
         realPrevTime = realCurrTime;
+
+        if (_reportStats.exchange(false))
+            reportStats();
     }
 
     LOG_INFO("elevator", "Stop update loop");
@@ -75,5 +302,11 @@ void ElevatorUpdateLoop()
 void TerminateHandler(int sigval)
 {
     LOG_WARN("elevator", "Caught signal: {}. Stop process", sigval);
-    sElevator->StopNow(SHUTDOWN_EXIT_CODE);
+    _exitCode = SHUTDOWN_EXIT_CODE;
+    _stopped = true;
+}
+
+void ReportStatsHandler(int /*sigval*/)
+{
+    _reportStats = true;
 }
@@ -267,6 +267,22 @@ void Warhead::Log::UsingDefaultLogs(bool value /*= true*/)
     }
 }
 
+void Warhead::Log::SetLoggerLevel(std::string_view name, LogLevel const level)
+{
+    auto logger = HasLogger(name);
+    if (!logger)
+        return;
+
+    logger->SetLevel(level);
+
+    // Recalculate highest log level across all loggers
+    highestLogLevel = LogLevel::Fatal;
+
+    for (auto const& [loggerName, itrLogger] : _loggers)
+        if (itrLogger->GetLevel() > highestLogLevel)
+            highestLogLevel = itrLogger->GetLevel();
+}
+
 Warhead::Logger* Warhead::Log::GetLoggerByType(std::string_view type)
 {
     if (auto logger = HasLogger(type))
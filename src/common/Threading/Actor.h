@@ -0,0 +1,137 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_ACTOR_H_
+#define WARHEAD_ACTOR_H_
+
+#include "MPSCQueue.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Warhead
+{
+    // Thread with own mailbox. Handler receives messages one by one on actor thread, so state owned by handler needs no lock.
+    // Messages are sent from any thread without lock. Mailbox is bounded, messages sent to full mailbox wait in locked overflow.
+    // Messages of one sender are received in send order. Thread sleeps while mailbox is empty
+    template<class Message>
+    class Actor
+    {
+    public:
+        using Handler = std::function<void(Message const&)>;
+
+        // Start actor thread. Mailbox capacity is rounded up to power of two
+        Actor(std::size_t mailboxCapacity, Handler&& handler) :
+            _mailbox(mailboxCapacity), _handler(std::move(handler)), _thread(&Actor::Run, this) { }
+
+        ~Actor() { Stop(); }
+
+        Actor(Actor const&) = delete;
+        Actor& operator=(Actor const&) = delete;
+
+        // Add message from any thread. Never blocks on full mailbox
+        void Send(Message const& message)
+        {
+            // Overflow is received after mailbox. Later messages join overflow until actor takes it, so they can't pass earlier ones
+            if (_hasOverflow.load(std::memory_order_acquire) || !_mailbox.TryPush(message))
+            {
+                std::lock_guard guard(_overflowLock);
+                _overflow.emplace_back(message);
+                _hasOverflow.store(true, std::memory_order_release);
+            }
+
+            Wake();
+        }
+
+        // Stop and join actor thread. Messages not received yet are dropped
+        void Stop()
+        {
+            if (_stopped.exchange(true))
+                return;
+
+            Wake();
+
+            if (_thread.joinable())
+                _thread.join();
+        }
+
+    private:
+        void Run()
+        {
+            while (!_stopped.load(std::memory_order_acquire))
+            {
+                // Read signal before mailbox, so message sent after check wakes thread
+                auto signal = _signal.load(std::memory_order_acquire);
+
+                if (!Receive())
+                    _signal.wait(signal, std::memory_order_acquire);
+            }
+        }
+
+        // Handle all messages in mailbox and overflow. Returns false if both were empty
+        bool Receive()
+        {
+            auto count = _mailbox.ConsumeAll(_handler);
+
+            if (_hasOverflow.load(std::memory_order_acquire))
+            {
+                {
+                    std::lock_guard guard(_overflowLock);
+                    _overflow.swap(_received);
+                    _hasOverflow.store(false, std::memory_order_relaxed);
+                }
+
+                for (auto const& message : _received)
+                    _handler(message);
+
+                count += _received.size();
+                _received.clear();
+            }
+
+            return count != 0;
+        }
+
+        void Wake()
+        {
+            _signal.fetch_add(1, std::memory_order_release);
+            _signal.notify_one();
+        }
+
+        MPSCQueue<Message> _mailbox;
+        Handler _handler;
+
+        // Messages sent to full mailbox
+        std::mutex _overflowLock;
+        std::vector<Message> _overflow;
+        std::atomic<bool> _hasOverflow{};
+
+        // Overflow taken by actor thread. Reused between batches
+        std::vector<Message> _received;
+
+        // Changed on every send. Actor thread sleeps on it
+        std::atomic<uint32> _signal{};
+        std::atomic<bool> _stopped{};
+
+        // Started last, after all members
+        std::thread _thread;
+    };
+}
+
+#endif
@@ -111,18 +111,6 @@ public:
         return _queue.size();
     }
 
-    StorageIterator begin()
-    {
-        std::lock_guard lock(_lock);
-        return _queue.begin();
-    }
-
-    StorageIterator end()
-    {
-        std::lock_guard lock(_lock);
-        return _queue.end();
-    }
-
     void Reset()
     {
         T* element{ nullptr };
@@ -0,0 +1,126 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_MPSC_QUEUE_H_
+#define WARHEAD_MPSC_QUEUE_H_
+
+#include "Define.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <memory>
+
+namespace Warhead
+{
+    // Bounded lock-free queue for many producers and one consumer. Storage is allocated once.
+    // Producer claims cell with one CAS on enqueue position and publishes it by cell sequence, so producers never wait for each other
+    // or for consumer. Consumer takes all published cells in one batch without atomic read-modify-write.
+    // Cell sequence: position - free for producer of position, position + 1 - filled, position + capacity - free for next round
+    template<class T>
+    class MPSCQueue
+    {
+        static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    public:
+        // Capacity is rounded up to power of two
+        explicit MPSCQueue(std::size_t capacity) :
+            _capacity(std::bit_ceil(std::max<std::size_t>(capacity, 2))), _cells(std::make_unique<Cell[]>(_capacity))
+        {
+            for (std::size_t i{}; i < _capacity; i++)
+                _cells[i].Sequence.store(i, std::memory_order_relaxed);
+        }
+
+        ~MPSCQueue() = default;
+
+        MPSCQueue(MPSCQueue const&) = delete;
+        MPSCQueue& operator=(MPSCQueue const&) = delete;
+
+        // Add value from any thread. Returns false if queue is full
+        bool TryPush(T const& value)
+        {
+            auto position = _enqueuePosition.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                auto& cell = _cells[position & (_capacity - 1)];
+                auto sequence = cell.Sequence.load(std::memory_order_acquire);
+                auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+                if (!difference)
+                {
+                    if (_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        cell.Value = value;
+                        cell.Sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                // Consumer didn't take value of previous round yet
+                else if (difference < 0)
+                    return false;
+                else
+                    position = _enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        // Call fn(value) for all published values in push order. Consumer thread only. Returns count of values
+        template<class Fn>
+        std::size_t ConsumeAll(Fn&& fn)
+        {
+            std::size_t count{};
+
+            for (;;)
+            {
+                auto& cell = _cells[_dequeuePosition & (_capacity - 1)];
+
+                // Stop at first cell claimed by producer but not published yet. It's taken by next batch
+                if (cell.Sequence.load(std::memory_order_acquire) != _dequeuePosition + 1)
+                    return count;
+
+                fn(cell.Value);
+                cell.Sequence.store(_dequeuePosition + _capacity, std::memory_order_release);
+                _dequeuePosition++;
+                count++;
+            }
+        }
+
+        // Check if no published values. Consumer thread only
+        [[nodiscard]] bool Empty() const
+        {
+            return _cells[_dequeuePosition & (_capacity - 1)].Sequence.load(std::memory_order_acquire) != _dequeuePosition + 1;
+        }
+
+        [[nodiscard]] inline std::size_t GetCapacity() const { return _capacity; }
+
+    private:
+        struct Cell
+        {
+            std::atomic<std::size_t> Sequence;
+            T Value{};
+        };
+
+        std::size_t const _capacity;
+        std::unique_ptr<Cell[]> const _cells;
+
+        // Producers and consumer positions on own cache lines
+        alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> _enqueuePosition{};
+        alignas(CACHE_LINE_SIZE) std::size_t _dequeuePosition{};
+    };
+}
+
+#endif
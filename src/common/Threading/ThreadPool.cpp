@@ -0,0 +1,86 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ThreadPool.h"
+#include <algorithm>
+
+Warhead::ThreadPool::ThreadPool(std::size_t threadCount /*= 0*/)
+{
+    if (!threadCount)
+        threadCount = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+
+    _threads.reserve(threadCount);
+
+    for (std::size_t i{}; i < threadCount; i++)
+        _threads.emplace_back(&ThreadPool::WorkerThread, this);
+}
+
+Warhead::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard guard(_lock);
+        _stopped = true;
+    }
+
+    _workCondition.notify_all();
+
+    for (auto& thread : _threads)
+        thread.join();
+}
+
+void Warhead::ThreadPool::PostWork(std::function<void()>&& work)
+{
+    {
+        std::lock_guard guard(_lock);
+        _works.emplace_back(std::move(work));
+        _pendingCount++;
+    }
+
+    _workCondition.notify_one();
+}
+
+void Warhead::ThreadPool::Wait()
+{
+    std::unique_lock lock(_lock);
+    _doneCondition.wait(lock, [this]() { return !_pendingCount; });
+}
+
+void Warhead::ThreadPool::WorkerThread()
+{
+    for (;;)
+    {
+        std::function<void()> work;
+
+        {
+            std::unique_lock lock(_lock);
+            _workCondition.wait(lock, [this]() { return _stopped || !_works.empty(); });
+
+            if (_works.empty())
+                return;
+
+            work = std::move(_works.front());
+            _works.pop_front();
+        }
+
+        work();
+
+        std::lock_guard guard(_lock);
+        if (!--_pendingCount)
+            _doneCondition.notify_all();
+    }
+}
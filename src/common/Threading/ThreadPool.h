@@ -0,0 +1,67 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_THREAD_POOL_H_
+#define WARHEAD_THREAD_POOL_H_
+
+#include "Define.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Warhead
+{
+    // Fixed count of worker threads executing posted work in post order
+    class WH_COMMON_API ThreadPool
+    {
+    public:
+        // 0 - use hardware concurrency
+        explicit ThreadPool(std::size_t threadCount = 0);
+        ~ThreadPool();
+
+        ThreadPool(ThreadPool const&) = delete;
+        ThreadPool& operator=(ThreadPool const&) = delete;
+
+        // Add work for any free worker
+        void PostWork(std::function<void()>&& work);
+
+        // Block until all posted work is done
+        void Wait();
+
+        [[nodiscard]] inline std::size_t GetThreadCount() const { return _threads.size(); }
+
+    private:
+        void WorkerThread();
+
+        std::vector<std::thread> _threads;
+        std::deque<std::function<void()>> _works;
+
+        std::mutex _lock;
+        std::condition_variable _workCondition;
+        std::condition_variable _doneCondition;
+
+        // Count of works posted and not finished
+        std::size_t _pendingCount{};
+        bool _stopped{};
+    };
+}
+
+#endif
@@ -0,0 +1,175 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+Warhead::WorkStealingPool::WorkStealingPool(std::size_t threadCount /*= 0*/)
+{
+    if (!threadCount)
+        threadCount = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+
+    _workers.reserve(threadCount);
+    for (std::size_t i{}; i < threadCount; i++)
+        _workers.emplace_back(std::make_unique<Worker>());
+
+    _threads.reserve(threadCount);
+    for (std::size_t i{}; i < threadCount; i++)
+        _threads.emplace_back(&WorkStealingPool::WorkerThread, this, i);
+}
+
+Warhead::WorkStealingPool::~WorkStealingPool()
+{
+    // Workers finish queued work before exit
+    _stopped.store(true, std::memory_order_release);
+
+    for (auto const& worker : _workers)
+        Wake(*worker);
+
+    for (auto& thread : _threads)
+        thread.join();
+}
+
+void Warhead::WorkStealingPool::PostWork(std::size_t worker, std::function<void()>&& work)
+{
+    worker %= _workers.size();
+    auto& home = *_workers[worker];
+
+    // Counted before push, so worker finishing work never sees count below zero
+    _pendingCount.fetch_add(1, std::memory_order_relaxed);
+
+    {
+        std::lock_guard guard(home.Lock);
+        home.Works.emplace_back(std::move(work));
+    }
+
+    Wake(home);
+
+    // Home worker takes work after current one. Free worker can steal it before
+    if (home.IsBusy.load(std::memory_order_acquire))
+        WakeFreeWorker(worker);
+}
+
+void Warhead::WorkStealingPool::Wait()
+{
+    for (;;)
+    {
+        auto pendingCount = _pendingCount.load(std::memory_order_acquire);
+        if (!pendingCount)
+            return;
+
+        _pendingCount.wait(pendingCount, std::memory_order_acquire);
+    }
+}
+
+void Warhead::WorkStealingPool::WorkerThread(std::size_t worker)
+{
+    auto& self = *_workers[worker];
+
+    for (;;)
+    {
+        // Read signal before queues, so work posted after check wakes thread
+        auto signal = self.Signal.load(std::memory_order_acquire);
+
+        std::function<void()> work;
+
+        if (!TakeWork(worker, work))
+        {
+            if (_stopped.load(std::memory_order_acquire))
+                return;
+
+            self.Signal.wait(signal, std::memory_order_acquire);
+            continue;
+        }
+
+        self.IsBusy.store(true, std::memory_order_release);
+
+        // Works wait behind this one. Free worker can steal them
+        if (HasWork(self))
+            WakeFreeWorker(worker);
+
+        work();
+        self.IsBusy.store(false, std::memory_order_release);
+
+        if (_pendingCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            _pendingCount.notify_all();
+    }
+}
+
+bool Warhead::WorkStealingPool::TakeWork(std::size_t worker, std::function<void()>& work)
+{
+    auto const workerCount = _workers.size();
+
+    for (std::size_t i{}; i < workerCount; i++)
+    {
+        auto& queue = *_workers[(worker + i) % workerCount];
+
+        // Free owner takes own work soon. Steal only work waiting behind busy owner
+        if (i && !queue.IsBusy.load(std::memory_order_acquire))
+            continue;
+
+        std::lock_guard guard(queue.Lock);
+        if (queue.Works.empty())
+            continue;
+
+        // Own work in post order. Stolen work from tail, away from owner
+        if (!i)
+        {
+            work = std::move(queue.Works.front());
+            queue.Works.pop_front();
+        }
+        else
+        {
+            work = std::move(queue.Works.back());
+            queue.Works.pop_back();
+            _stealCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+bool Warhead::WorkStealingPool::HasWork(Worker& worker)
+{
+    std::lock_guard guard(worker.Lock);
+    return !worker.Works.empty();
+}
+
+void Warhead::WorkStealingPool::Wake(Worker& worker)
+{
+    worker.Signal.fetch_add(1, std::memory_order_release);
+    worker.Signal.notify_one();
+}
+
+void Warhead::WorkStealingPool::WakeFreeWorker(std::size_t homeWorker)
+{
+    auto const workerCount = _workers.size();
+
+    // Start from next worker, so neighbours of busy worker help first
+    for (std::size_t i = 1; i < workerCount; i++)
+    {
+        auto& worker = *_workers[(homeWorker + i) % workerCount];
+        if (!worker.IsBusy.load(std::memory_order_acquire))
+        {
+            Wake(worker);
+            return;
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_WORK_STEALING_POOL_H_
+#define WARHEAD_WORK_STEALING_POOL_H_
+
+#include "Define.h"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Warhead
+{
+    // Worker threads with own work queues. Work is posted to queue of selected worker, so same work source stays on same thread
+    // and keeps its data in cache. Post wakes only that home worker. Free worker is woken too only if home worker is busy,
+    // it steals from tail of queues of busy workers, so one busy queue doesn't stall pool. Post and finish of work take no global lock
+    class WH_COMMON_API WorkStealingPool
+    {
+    public:
+        // 0 - use hardware concurrency
+        explicit WorkStealingPool(std::size_t threadCount = 0);
+        ~WorkStealingPool();
+
+        WorkStealingPool(WorkStealingPool const&) = delete;
+        WorkStealingPool& operator=(WorkStealingPool const&) = delete;
+
+        // Add work in queue of worker. Worker index is taken modulo thread count
+        void PostWork(std::size_t worker, std::function<void()>&& work);
+
+        // Block until all posted work is done
+        void Wait();
+
+        [[nodiscard]] inline std::size_t GetThreadCount() const { return _threads.size(); }
+
+        // Count of works posted and not finished
+        [[nodiscard]] inline std::size_t GetPendingCount() const { return _pendingCount.load(std::memory_order_acquire); }
+
+        // Count of works done by other worker than they were posted to
+        [[nodiscard]] inline uint64 GetStealCount() const { return _stealCount.load(std::memory_order_relaxed); }
+
+    private:
+        struct Worker
+        {
+            std::mutex Lock;
+            std::deque<std::function<void()>> Works;
+
+            // Changed on every wake up. Worker thread sleeps on it
+            std::atomic<uint32> Signal{};
+
+            // Worker runs work and can't take new one now
+            std::atomic<bool> IsBusy{};
+        };
+
+        void WorkerThread(std::size_t worker);
+
+        // Take work from head of own queue or tail of queue of busy worker. Returns false if no work can be taken
+        bool TakeWork(std::size_t worker, std::function<void()>& work);
+
+        // Check if works wait in queue of worker
+        static bool HasWork(Worker& worker);
+
+        // Wake sleeping worker thread
+        static void Wake(Worker& worker);
+
+        // Wake one free worker other than home one to steal work
+        void WakeFreeWorker(std::size_t homeWorker);
+
+        std::vector<std::unique_ptr<Worker>> _workers;
+        std::vector<std::thread> _threads;
+
+        // Count of works posted and not finished. Wait sleeps on it
+        std::atomic<std::size_t> _pendingCount{};
+        std::atomic<bool> _stopped{};
+
+        std::atomic<uint64> _stealCount{};
+    };
+}
+
+#endif
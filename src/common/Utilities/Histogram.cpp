@@ -0,0 +1,65 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Histogram.h"
+#include <cmath>
+
+static_assert(Warhead::LogLinearHistogram::GetBucketIndex(Warhead::LogLinearHistogram::MAX_VALUE) + 1 == Warhead::LogLinearHistogram::BUCKET_COUNT);
+
+void Warhead::LogLinearHistogram::Merge(LogLinearHistogram const& other)
+{
+    for (std::size_t i{}; i < BUCKET_COUNT; i++)
+        _counts[i] += other._counts[i];
+
+    _count += other._count;
+    _sum += other._sum;
+    _max = std::max(_max, other._max);
+}
+
+void Warhead::LogLinearHistogram::Clear()
+{
+    _counts.fill(0);
+    _count = 0;
+    _sum = 0;
+    _max = 0;
+}
+
+double Warhead::LogLinearHistogram::GetMean() const
+{
+    return _count ? static_cast<double>(_sum) / static_cast<double>(_count) : 0.0;
+}
+
+uint64 Warhead::LogLinearHistogram::GetPercentile(double percent) const
+{
+    if (!_count)
+        return 0;
+
+    auto rank = static_cast<uint64>(std::ceil(std::clamp(percent, 0.0, 100.0) / 100.0 * static_cast<double>(_count)));
+    rank = std::max<uint64>(rank, 1);
+
+    uint64 seen{};
+
+    for (std::size_t i{}; i < BUCKET_COUNT; i++)
+    {
+        seen += _counts[i];
+        if (seen >= rank)
+            return std::min(GetBucketUpperBound(i), _max);
+    }
+
+    return _max;
+}
@@ -0,0 +1,92 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_HISTOGRAM_H_
+#define WARHEAD_HISTOGRAM_H_
+
+#include "Define.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace Warhead
+{
+    // Log-linear histogram of integer values. Every power of two range is split in 16 linear buckets,
+    // so bucket width is at most 1/16 of value. Values below 32 are exact. Add is branch light and O(1)
+    class WH_COMMON_API LogLinearHistogram
+    {
+    public:
+        // Linear buckets per power of two: 2^SUB_BUCKET_BITS
+        static constexpr uint8 SUB_BUCKET_BITS = 4;
+        static constexpr uint64 SUB_BUCKET_COUNT = uint64(1) << SUB_BUCKET_BITS;
+
+        // Values above this are counted in last bucket
+        static constexpr uint8 MAX_VALUE_BITS = 32;
+        static constexpr uint64 MAX_VALUE = (uint64(1) << MAX_VALUE_BITS) - 1;
+
+        static constexpr std::size_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+        static constexpr std::size_t GetBucketIndex(uint64 value)
+        {
+            value = std::min(value, MAX_VALUE);
+
+            if (value < 2 * SUB_BUCKET_COUNT)
+                return static_cast<std::size_t>(value);
+
+            auto shift = static_cast<uint64>(std::bit_width(value)) - (SUB_BUCKET_BITS + 1);
+            return static_cast<std::size_t>((shift + 1) * SUB_BUCKET_COUNT + (value >> shift) - SUB_BUCKET_COUNT);
+        }
+
+        // Highest value counted in bucket
+        static constexpr uint64 GetBucketUpperBound(std::size_t index)
+        {
+            if (index < 2 * SUB_BUCKET_COUNT)
+                return index;
+
+            auto shift = index / SUB_BUCKET_COUNT - 1;
+            auto base = (index % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT) << shift;
+            return base + (uint64(1) << shift) - 1;
+        }
+
+        inline void Add(uint64 value)
+        {
+            _counts[GetBucketIndex(value)]++;
+            _count++;
+            _sum += value;
+            _max = std::max(_max, value);
+        }
+
+        void Merge(LogLinearHistogram const& other);
+        void Clear();
+
+        [[nodiscard]] inline uint64 GetCount() const { return _count; }
+        [[nodiscard]] inline uint64 GetMax() const { return _max; }
+        [[nodiscard]] double GetMean() const;
+
+        // Value not lower than percent of all values, 0..100. Result is bucket upper bound, so error is at most bucket width
+        [[nodiscard]] uint64 GetPercentile(double percent) const;
+
+    private:
+        std::array<uint64, BUCKET_COUNT> _counts{};
+        uint64 _count{};
+        uint64 _sum{};
+        uint64 _max{};
+    };
+}
+
+#endif
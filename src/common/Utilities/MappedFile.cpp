@@ -0,0 +1,144 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MappedFile.h"
+
+#if WARHEAD_PLATFORM == WARHEAD_PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+Warhead::MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#if WARHEAD_PLATFORM == WARHEAD_PLATFORM_WINDOWS
+bool Warhead::MappedFile::Open(std::string const& path)
+{
+    Close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    if (!size.QuadPart)
+    {
+        CloseHandle(file);
+        _isEmpty = true;
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    auto data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    _file = file;
+    _mapping = mapping;
+    _data = static_cast<uint8 const*>(data);
+    _size = static_cast<std::size_t>(size.QuadPart);
+    return true;
+}
+
+void Warhead::MappedFile::Close()
+{
+    if (_data)
+        UnmapViewOfFile(_data);
+
+    if (_mapping)
+        CloseHandle(_mapping);
+
+    if (_file)
+        CloseHandle(_file);
+
+    _data = nullptr;
+    _mapping = nullptr;
+    _file = nullptr;
+    _size = 0;
+    _isEmpty = false;
+}
+#else
+bool Warhead::MappedFile::Open(std::string const& path)
+{
+    Close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info{};
+    if (::fstat(fd, &info) < 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    if (!info.st_size)
+    {
+        ::close(fd);
+        _isEmpty = true;
+        return true;
+    }
+
+    auto data = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // Mapping holds own reference to file
+    ::close(fd);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    ::madvise(data, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+
+    _data = static_cast<uint8 const*>(data);
+    _size = static_cast<std::size_t>(info.st_size);
+    return true;
+}
+
+void Warhead::MappedFile::Close()
+{
+    if (_data)
+        ::munmap(const_cast<uint8*>(_data), _size);
+
+    _data = nullptr;
+    _size = 0;
+    _isEmpty = false;
+}
+#endif
@@ -0,0 +1,59 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_MAPPED_FILE_H_
+#define WARHEAD_MAPPED_FILE_H_
+
+#include "Define.h"
+#include <string>
+
+namespace Warhead
+{
+    // Read only memory mapped file. Pages are loaded by OS on access, so file is never read whole
+    class WH_COMMON_API MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(MappedFile const&) = delete;
+        MappedFile& operator=(MappedFile const&) = delete;
+
+        // Map whole file. Hint OS about sequential access for read ahead
+        bool Open(std::string const& path);
+        void Close();
+
+        [[nodiscard]] inline bool IsOpen() const { return _data != nullptr || _isEmpty; }
+        [[nodiscard]] inline uint8 const* GetData() const { return _data; }
+        [[nodiscard]] inline std::size_t GetSize() const { return _size; }
+
+    private:
+        uint8 const* _data{};
+        std::size_t _size{};
+
+        // Empty file can't be mapped, but is valid
+        bool _isEmpty{};
+
+#if WARHEAD_PLATFORM == WARHEAD_PLATFORM_WINDOWS
+        void* _file{};
+        void* _mapping{};
+#endif
+    };
+}
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_RANDOM_H_
+#define WARHEAD_RANDOM_H_
+
+#include "Define.h"
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace Warhead
+{
+    // SplitMix64 step. Turns sequential or poor seeds into well mixed independent seeds
+    constexpr uint64 SplitMix64(uint64& state)
+    {
+        uint64 z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Seed of stream with index derived from base seed. Same base seed and index give same seed
+    constexpr uint64 GetStreamSeed(uint64 baseSeed, uint64 streamIndex)
+    {
+        uint64 state = baseSeed ^ SplitMix64(streamIndex);
+        return SplitMix64(state);
+    }
+
+    // xoshiro256** generator. Small state, fast and good enough for simulation streams.
+    // Satisfies UniformRandomBitGenerator, so can be used with std distributions
+    class Xoshiro256
+    {
+    public:
+        using result_type = uint64;
+
+        explicit constexpr Xoshiro256(uint64 seed = 0) { Seed(seed); }
+
+        // Fill state from seed with SplitMix64 as recommended by generator authors
+        constexpr void Seed(uint64 seed)
+        {
+            for (auto& word : _state)
+                word = SplitMix64(seed);
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        constexpr result_type operator()()
+        {
+            uint64 const result = std::rotl(_state[1] * 5, 7) * 9;
+            uint64 const t = _state[1] << 17;
+
+            _state[2] ^= _state[0];
+            _state[3] ^= _state[1];
+            _state[1] ^= _state[2];
+            _state[0] ^= _state[3];
+            _state[2] ^= t;
+            _state[3] = std::rotl(_state[3], 45);
+
+            return result;
+        }
+
+        // Bulk generation. State stays in registers for whole loop
+        constexpr void Fill(uint64* values, std::size_t count)
+        {
+            for (std::size_t i{}; i < count; i++)
+                values[i] = (*this)();
+        }
+
+        // Uniform value in [0, bound) without modulo bias (Lemire)
+        constexpr uint32 NextBelow(uint32 bound)
+        {
+            uint64 product = ((*this)() >> 32) * bound;
+            auto low = static_cast<uint32>(product);
+
+            if (low < bound)
+            {
+                uint32 const threshold = static_cast<uint32>(-bound) % bound;
+                while (low < threshold)
+                {
+                    product = ((*this)() >> 32) * bound;
+                    low = static_cast<uint32>(product);
+                }
+            }
+
+            return static_cast<uint32>(product >> 32);
+        }
+
+        // Uniform value in [0, 1)
+        constexpr double NextDouble()
+        {
+            return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+        }
+
+        // Exponential distributed value with rate
+        double NextExponential(double rate)
+        {
+            return -std::log1p(-NextDouble()) / rate;
+        }
+
+        // Advance state by 2^128 steps. Gives non overlapping sub streams of one seed
+        constexpr void Jump()
+        {
+            constexpr uint64 JUMP[] = { 0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL };
+
+            uint64 state[4]{};
+
+            for (auto jump : JUMP)
+            {
+                for (uint8 bit{}; bit < 64; bit++)
+                {
+                    if (jump & (uint64(1) << bit))
+                        for (std::size_t i{}; i < 4; i++)
+                            state[i] ^= _state[i];
+
+                    (*this)();
+                }
+            }
+
+            for (std::size_t i{}; i < 4; i++)
+                _state[i] = state[i];
+        }
+
+    private:
+        uint64 _state[4]{};
+    };
+}
+
+#endif
@@ -0,0 +1,59 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Building.h"
+#include "Config.h"
+#include "Log.h"
+
+/*static*/ BuildingGeometry BuildingGeometry::LoadFromConfig()
+{
+    BuildingGeometry geometry;
+    BuildingGeometry const defaultGeometry;
+
+    geometry.MinFloor = sConfigMgr->GetOption<int16>("Building.MinFloor", defaultGeometry.MinFloor);
+    geometry.MaxFloor = sConfigMgr->GetOption<int16>("Building.MaxFloor", defaultGeometry.MaxFloor);
+    geometry.LobbyFloor = sConfigMgr->GetOption<int16>("Building.LobbyFloor", defaultGeometry.LobbyFloor);
+
+    if (geometry.MinFloor > geometry.MaxFloor)
+    {
+        LOG_ERROR("building", "> Building: MinFloor ({}) is higher than MaxFloor ({}). Use default floors", geometry.MinFloor, geometry.MaxFloor);
+        geometry.MinFloor = defaultGeometry.MinFloor;
+        geometry.MaxFloor = defaultGeometry.MaxFloor;
+    }
+
+    if (!geometry.IsValidFloor(geometry.LobbyFloor))
+    {
+        LOG_ERROR("building", "> Building: LobbyFloor ({}) is out of floors {}..{}. Use MinFloor", geometry.LobbyFloor, geometry.MinFloor, geometry.MaxFloor);
+        geometry.LobbyFloor = geometry.MinFloor;
+    }
+
+    LOG_INFO("building", "> Building: Floors {}..{} ({} floors), lobby floor {}", geometry.MinFloor, geometry.MaxFloor, geometry.GetFloorCount(), geometry.LobbyFloor);
+    return geometry;
+}
+
+/*static*/ CarCapacity CarCapacity::LoadFromConfig()
+{
+    CarCapacity capacity;
+    CarCapacity const defaultCapacity;
+
+    capacity.Persons = sConfigMgr->GetOption<uint32>("Building.CarCapacity.Persons", defaultCapacity.Persons);
+    capacity.Load = sConfigMgr->GetOption<uint32>("Building.CarCapacity.Load", defaultCapacity.Load);
+
+    LOG_INFO("building", "> Building: Car capacity {} persons, {} kg", capacity.Persons, capacity.Load);
+    return capacity;
+}
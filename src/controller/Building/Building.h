@@ -0,0 +1,68 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_BUILDING_H_
+#define WARHEAD_BUILDING_H_
+
+#include "Define.h"
+
+// Floor number. Negative floors are basements
+using Floor = int16;
+
+// Floors served by elevators in building
+struct WH_CTRL_API BuildingGeometry
+{
+    // Load geometry from config. Invalid values replaced by defaults
+    static BuildingGeometry LoadFromConfig();
+
+    // Count of floors between min and max floors
+    [[nodiscard]] constexpr uint32 GetFloorCount() const { return static_cast<uint32>(MaxFloor - MinFloor) + 1; }
+
+    // Check floor between min and max floors
+    [[nodiscard]] constexpr bool IsValidFloor(Floor floor) const { return floor >= MinFloor && floor <= MaxFloor; }
+
+    // Zero based index of floor. Used for per floor storage
+    [[nodiscard]] constexpr uint32 GetFloorIndex(Floor floor) const { return static_cast<uint32>(floor - MinFloor); }
+
+    // Floor by zero based index
+    [[nodiscard]] constexpr Floor GetFloorByIndex(uint32 index) const { return static_cast<Floor>(MinFloor + static_cast<int32>(index)); }
+
+    // Lowest floor. Can be negative for basements
+    Floor MinFloor{ 1 };
+
+    // Highest floor
+    Floor MaxFloor{ 9 };
+
+    // Main entrance floor. Cars wait here on start
+    Floor LobbyFloor{ 1 };
+};
+
+// Rated load of car. 0 - no limit
+struct WH_CTRL_API CarCapacity
+{
+    // Load capacity from config
+    static CarCapacity LoadFromConfig();
+
+    // Max count of passengers in car
+    uint32 Persons{};
+
+    // Max load of car in kg
+    uint32 Load{};
+};
+
+#endif
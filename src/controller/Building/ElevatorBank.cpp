@@ -0,0 +1,91 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ElevatorBank.h"
+#include "Config.h"
+#include "Log.h"
+#include "StringConvert.h"
+#include "Tokenize.h"
+#include <algorithm>
+
+/*static*/ std::vector<ElevatorBank> ElevatorBank::LoadFromConfig(BuildingGeometry const& geometry)
+{
+    auto text = sConfigMgr->GetOption<std::string>("Building.Banks", "");
+    if (text.empty())
+        return {};
+
+    auto banks = Parse(text, geometry);
+    if (!banks)
+    {
+        LOG_ERROR("building", "> Building: Incorrect banks \"{}\". All cars serve all floors", text);
+        return {};
+    }
+
+    for (auto const& bank : *banks)
+        LOG_INFO("building", "> Building: Bank {} with {} cars serves {} floors {}..{}", bank.Name, bank.CarCount, bank.Floors.size(), bank.Floors.front(), bank.Floors.back());
+
+    return std::move(*banks);
+}
+
+/*static*/ std::optional<std::vector<ElevatorBank>> ElevatorBank::Parse(std::string_view text, BuildingGeometry const& geometry)
+{
+    std::vector<ElevatorBank> banks;
+
+    for (auto bankText : Warhead::Tokenize(text, ';', false))
+    {
+        auto parts = Warhead::Tokenize(bankText, ':', true);
+        if (parts.size() != 3)
+            return {};
+
+        ElevatorBank bank;
+        bank.Name = parts[0];
+
+        auto carCount = Warhead::StringTo<uint32>(parts[2]);
+        if (!carCount || !*carCount)
+            return {};
+
+        bank.CarCount = *carCount;
+
+        for (auto floorText : Warhead::Tokenize(parts[1], ',', false))
+        {
+            // Range "first..last". Floors can be negative, so ranges don't use '-'
+            auto separator = floorText.find("..");
+            auto first = Warhead::StringTo<Floor>(floorText.substr(0, separator));
+            auto last = separator == std::string_view::npos ? first : Warhead::StringTo<Floor>(floorText.substr(separator + 2));
+
+            if (!first || !last || *first > *last || !geometry.IsValidFloor(*first) || !geometry.IsValidFloor(*last))
+                return {};
+
+            for (auto floor = *first; floor <= *last; floor++)
+                bank.Floors.emplace_back(floor);
+        }
+
+        // Car with one floor never moves passengers
+        std::sort(bank.Floors.begin(), bank.Floors.end());
+        bank.Floors.erase(std::unique(bank.Floors.begin(), bank.Floors.end()), bank.Floors.end());
+        if (bank.Floors.size() < 2)
+            return {};
+
+        banks.emplace_back(std::move(bank));
+    }
+
+    if (banks.empty())
+        return {};
+
+    return banks;
+}
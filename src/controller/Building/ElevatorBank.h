@@ -0,0 +1,47 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_ELEVATOR_BANK_H_
+#define WARHEAD_ELEVATOR_BANK_H_
+
+#include "Building.h"
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Cars serving same floors. Zoned building has low-rise, high-rise and express banks
+struct WH_CTRL_API ElevatorBank
+{
+    // Load banks from config. Empty - all cars serve all floors
+    static std::vector<ElevatorBank> LoadFromConfig(BuildingGeometry const& geometry);
+
+    // Parse banks from "Name:floors:cars;...". Floors are comma separated floors and ranges, for example
+    // "Low:1..20:4;Express:1,40:2;High:40..60:4". Empty - text is invalid or has floors out of geometry
+    static std::optional<std::vector<ElevatorBank>> Parse(std::string_view text, BuildingGeometry const& geometry);
+
+    std::string Name;
+
+    // Count of cars in bank
+    uint32 CarCount{};
+
+    // Served floors in ascending order
+    std::vector<Floor> Floors;
+};
+
+#endif
@@ -0,0 +1,411 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "CallAllocator.h"
+#include "Config.h"
+#include "Random.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Search iterations between deadline and cancel checks
+    constexpr uint64 DEADLINE_CHECK_INTERVAL = 128;
+
+    // Stop on car route. Distance in floors along route
+    struct RouteStop
+    {
+        uint32 Distance{};
+        uint32 Count{};
+    };
+
+    // Cost of car serving its riders and calls in collective sweep: sum of passenger times until destination.
+    // Waiting passengers count from now until pickup and from now until their destination
+    uint64 GetCarCost(AllocationProblem const& problem, uint32 carIndex, std::span<uint32 const> calls, std::vector<RouteStop>& route)
+    {
+        auto const& car = problem.Cars[carIndex];
+        auto riders = std::span(problem.RiderStops).subspan(car.FirstRiderStop, car.RiderStopCount);
+        auto getDestinations = [&problem](AllocationCall const& call)
+        {
+            return std::span(problem.DestinationStops).subspan(call.FirstDestinationStop, call.DestinationStopCount);
+        };
+
+        if (riders.empty() && calls.empty())
+            return 0;
+
+        auto top = car.FloorIndex;
+        auto bottom = car.FloorIndex;
+
+        auto extend = [&top, &bottom](uint32 floorIndex)
+        {
+            top = std::max(top, floorIndex);
+            bottom = std::min(bottom, floorIndex);
+        };
+
+        for (auto const& stop : riders)
+            extend(stop.FloorIndex);
+
+        for (auto callIndex : calls)
+        {
+            auto const& call = problem.Calls[callIndex];
+            extend(call.FloorIndex);
+
+            for (auto const& stop : getDestinations(call))
+                extend(stop.FloorIndex);
+        }
+
+        // Car without stops ahead turns around at once
+        bool isUp = car.Movement == MovementType::Up;
+        if (isUp && top == car.FloorIndex)
+            isUp = false;
+        else if (!isUp && bottom == car.FloorIndex)
+            isUp = true;
+
+        // Positions along sweep direction. Down sweep is mirrored up sweep
+        auto getPosition = [isUp](uint32 floorIndex) { return isUp ? static_cast<int64>(floorIndex) : -static_cast<int64>(floorIndex); };
+
+        auto start = getPosition(car.FloorIndex);
+        auto high = isUp ? static_cast<int64>(top) : -static_cast<int64>(bottom);
+        auto low = isUp ? static_cast<int64>(bottom) : -static_cast<int64>(top);
+
+        // Distance in floors to position on sweep: ahead of car, on way back from far end, ahead again after turn at near end
+        auto getDistance = [start, high, low](int64 position, uint32 sweep) -> uint32
+        {
+            switch (sweep)
+            {
+                case 0:
+                    return static_cast<uint32>(position - start);
+                case 1:
+                    return static_cast<uint32>((high - start) + (high - position));
+                default:
+                    return static_cast<uint32>((high - start) + (high - low) + (position - low));
+            }
+        };
+
+        route.clear();
+
+        for (auto const& stop : riders)
+        {
+            auto position = getPosition(stop.FloorIndex);
+            route.push_back({ getDistance(position, position >= start ? 0 : 1), stop.Count });
+        }
+
+        for (auto callIndex : calls)
+        {
+            auto const& call = problem.Calls[callIndex];
+            auto position = getPosition(call.FloorIndex);
+
+            uint32 sweep = 1;
+            if ((call.Direction == MovementType::Up) == isUp)
+                sweep = position >= start ? 0 : 2;
+
+            route.push_back({ getDistance(position, sweep), call.Count });
+
+            // Passengers ride in call direction, so destinations are on same sweep
+            for (auto const& stop : getDestinations(call))
+                route.push_back({ getDistance(getPosition(stop.FloorIndex), sweep), stop.Count });
+        }
+
+        std::sort(route.begin(), route.end(), [](RouteStop const& left, RouteStop const& right) { return left.Distance < right.Distance; });
+
+        auto travelTime = static_cast<uint64>(problem.Timing.FloorTravelTime.count());
+        auto stopTime = static_cast<uint64>(problem.Timing.StopTime.count());
+
+        uint64 cost{};
+        uint64 stopCount{};
+
+        for (std::size_t i{}; i < route.size(); i++)
+        {
+            // Stops on same floor of same sweep are one stop
+            if (i && route[i].Distance != route[i - 1].Distance)
+                stopCount++;
+
+            cost += (route[i].Distance * travelTime + stopCount * stopTime) * route[i].Count;
+        }
+
+        return cost;
+    }
+}
+
+void AllocationProblem::Clear()
+{
+    Cars.clear();
+    RiderStops.clear();
+    Calls.clear();
+    DestinationStops.clear();
+}
+
+/*static*/ CallAllocatorConfig CallAllocatorConfig::LoadFromConfig()
+{
+    CallAllocatorConfig config;
+    CallAllocatorConfig const defaultConfig;
+
+    config.Interval = Milliseconds(sConfigMgr->GetOption<uint32>("Dispatch.Reallocation.Interval", static_cast<uint32>(defaultConfig.Interval.count())));
+    config.Budget = Microseconds(sConfigMgr->GetOption<uint32>("Dispatch.Reallocation.Budget", static_cast<uint32>(defaultConfig.Budget.count())));
+    config.Iterations = sConfigMgr->GetOption<uint64>("Dispatch.Reallocation.Iterations", defaultConfig.Iterations);
+    config.ChainCount = sConfigMgr->GetOption<uint32>("Dispatch.Reallocation.ChainCount", static_cast<uint32>(defaultConfig.ChainCount));
+    config.ThreadCount = sConfigMgr->GetOption<uint32>("Dispatch.Reallocation.ThreadCount", static_cast<uint32>(defaultConfig.ThreadCount));
+    return config;
+}
+
+CallAllocator::CallAllocator(CallAllocatorConfig const& config) :
+    _config(config)
+{
+    if (!_config.IsInline)
+        _pool = std::make_unique<Warhead::ThreadPool>(_config.ThreadCount);
+}
+
+CallAllocator::~CallAllocator()
+{
+    Cancel();
+
+    if (_pool)
+        _pool->Wait();
+}
+
+bool CallAllocator::Start(AllocationProblem& problem)
+{
+    if (_running.exchange(true, std::memory_order_acq_rel))
+        return false;
+
+    std::swap(_problem, problem);
+    _cancel.store(false, std::memory_order_relaxed);
+    _searchCount++;
+
+    std::vector<uint32> assignment(_problem.Calls.size());
+    for (std::size_t i{}; i < assignment.size(); i++)
+        assignment[i] = _problem.Calls[i].CarIndex;
+
+    _initialCost = GetCost(_problem, assignment);
+
+    // Nothing to move
+    if (_problem.Calls.empty() || _problem.Cars.size() < 2)
+    {
+        _running.store(false, std::memory_order_release);
+        return true;
+    }
+
+    auto chainCount = _config.ChainCount;
+    if (!chainCount)
+        chainCount = _pool ? _pool->GetThreadCount() : 1;
+
+    _results.resize(chainCount);
+    _runningChains.store(chainCount, std::memory_order_relaxed);
+    _deadline = std::chrono::steady_clock::now() + _config.Budget;
+
+    if (!_pool)
+    {
+        for (std::size_t i{}; i < chainCount; i++)
+        {
+            RunChain(i);
+            FinishChain();
+        }
+
+        return true;
+    }
+
+    for (std::size_t i{}; i < chainCount; i++)
+    {
+        _pool->PostWork([this, i]()
+        {
+            RunChain(i);
+            FinishChain();
+        });
+    }
+
+    return true;
+}
+
+std::shared_ptr<AllocationPlan const> CallAllocator::TakePlan()
+{
+    return _plan.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+std::shared_ptr<AllocationPlan const> CallAllocator::WaitPlan()
+{
+    if (_pool)
+        _pool->Wait();
+
+    return TakePlan();
+}
+
+/*static*/ uint64 CallAllocator::GetCost(AllocationProblem const& problem, std::span<uint32 const> assignment)
+{
+    std::vector<std::vector<uint32>> carCalls(problem.Cars.size());
+    std::vector<RouteStop> route;
+
+    for (std::size_t i{}; i < assignment.size(); i++)
+        carCalls[assignment[i]].emplace_back(static_cast<uint32>(i));
+
+    uint64 cost{};
+
+    for (std::size_t i{}; i < carCalls.size(); i++)
+        cost += GetCarCost(problem, static_cast<uint32>(i), carCalls[i], route);
+
+    return cost;
+}
+
+void CallAllocator::RunChain(std::size_t chainIndex)
+{
+    auto const& problem = _problem;
+    auto& result = _results[chainIndex];
+
+    auto callCount = static_cast<uint32>(problem.Calls.size());
+    auto carCount = static_cast<uint32>(problem.Cars.size());
+
+    Warhead::Xoshiro256 random{ Warhead::GetStreamSeed(_config.Seed + _searchCount, chainIndex) };
+
+    // Calls of every car and position of call in its car list
+    std::vector<std::vector<uint32>> carCalls(carCount);
+    std::vector<uint32> positions(callCount);
+    std::vector<uint32> assignment(callCount);
+    std::vector<RouteStop> route;
+
+    for (uint32 i{}; i < callCount; i++)
+    {
+        auto carIndex = problem.Calls[i].CarIndex;
+        assignment[i] = carIndex;
+        positions[i] = static_cast<uint32>(carCalls[carIndex].size());
+        carCalls[carIndex].emplace_back(i);
+    }
+
+    std::vector<uint64> carCosts(carCount);
+    uint64 cost{};
+
+    for (uint32 i{}; i < carCount; i++)
+        cost += carCosts[i] = GetCarCost(problem, i, carCalls[i], route);
+
+    result.Assignment = assignment;
+    result.Cost = cost;
+    result.Iterations = 0;
+
+    auto moveCall = [&](uint32 callIndex, uint32 from, uint32 to)
+    {
+        auto& fromCalls = carCalls[from];
+        auto last = fromCalls.back();
+        fromCalls[positions[callIndex]] = last;
+        positions[last] = positions[callIndex];
+        fromCalls.pop_back();
+
+        positions[callIndex] = static_cast<uint32>(carCalls[to].size());
+        carCalls[to].emplace_back(callIndex);
+    };
+
+    auto const movePenalty = static_cast<int64>(problem.Timing.StopTime.count());
+
+    // Accept delay of one extra stop for one passenger at start, only improvements at deadline
+    auto const startTemperature = static_cast<double>(problem.Timing.StopTime.count());
+    auto const budget = static_cast<double>(_config.Budget.count());
+    auto const startTime = _deadline - _config.Budget;
+    double temperature = startTemperature;
+
+    for (uint64 iteration{};; iteration++)
+    {
+        if (iteration % DEADLINE_CHECK_INTERVAL == 0 || iteration == _config.Iterations)
+        {
+            // Part of search done. Iteration limit doesn't read clock, so chain is same on any machine
+            double progress{};
+
+            if (_config.Iterations)
+                progress = static_cast<double>(iteration) / static_cast<double>(_config.Iterations);
+            else if (auto now = std::chrono::steady_clock::now(); now < _deadline)
+                progress = static_cast<double>(std::chrono::duration_cast<Microseconds>(now - startTime).count()) / budget;
+            else
+                progress = 1.0;
+
+            if (progress >= 1.0 || _cancel.load(std::memory_order_relaxed))
+            {
+                result.Iterations = iteration;
+                break;
+            }
+
+            temperature = startTemperature * (1.0 - progress);
+        }
+
+        auto callIndex = random.NextBelow(callCount);
+        auto from = assignment[callIndex];
+        auto to = random.NextBelow(carCount - 1);
+        if (to >= from)
+            to++;
+
+        // Car of other bank doesn't stop on call floor
+        auto const& call = problem.Calls[callIndex];
+        if (to < 64 && !(call.CarMask & (uint64(1) << to)))
+            continue;
+
+        moveCall(callIndex, from, to);
+
+        auto fromCost = GetCarCost(problem, from, carCalls[from], route);
+        auto toCost = GetCarCost(problem, to, carCalls[to], route);
+        auto delta = static_cast<int64>(fromCost + toCost) - static_cast<int64>(carCosts[from] + carCosts[to]);
+
+        // Moved call costs one extra stop, so calls don't jump between cars for tiny gain
+        if (from == call.CarIndex)
+            delta += movePenalty;
+        else if (to == call.CarIndex)
+            delta -= movePenalty;
+
+        if (delta > 0 && (temperature <= 0.0 || random.NextDouble() >= std::exp(-static_cast<double>(delta) / temperature)))
+        {
+            moveCall(callIndex, to, from);
+            continue;
+        }
+
+        carCosts[from] = fromCost;
+        carCosts[to] = toCost;
+        assignment[callIndex] = to;
+        cost = static_cast<uint64>(static_cast<int64>(cost) + delta);
+
+        if (cost < result.Cost)
+        {
+            result.Cost = cost;
+            result.Assignment = assignment;
+        }
+    }
+}
+
+void CallAllocator::FinishChain()
+{
+    if (_runningChains.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    auto best = std::min_element(_results.begin(), _results.end(), [](ChainResult const& left, ChainResult const& right) { return left.Cost < right.Cost; });
+
+    auto plan = std::make_shared<AllocationPlan>();
+    plan->InitialCost = _initialCost;
+    plan->Cost = best->Cost;
+
+    for (auto const& result : _results)
+        plan->Iterations += result.Iterations;
+
+    // Chain cost includes move penalty, so best cost below initial is real gain
+    if (best->Cost < _initialCost)
+    {
+        for (std::size_t i{}; i < _problem.Calls.size(); i++)
+        {
+            auto const& call = _problem.Calls[i];
+            if (best->Assignment[i] != call.CarIndex)
+                plan->Moves.push_back({ call.FloorIndex, call.Direction, call.CarIndex, best->Assignment[i] });
+        }
+    }
+
+    if (!plan->Moves.empty())
+        _plan.store(std::move(plan), std::memory_order_release);
+
+    _running.store(false, std::memory_order_release);
+}
@@ -0,0 +1,200 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_CALL_ALLOCATOR_H_
+#define WARHEAD_CALL_ALLOCATOR_H_
+
+#include "EtaTable.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <span>
+#include <vector>
+
+// Car state in allocation problem
+struct AllocationCar
+{
+    uint32 FloorIndex{};
+    MovementType Movement{ MovementType::Up };
+
+    // Range of car stops in AllocationProblem::RiderStops
+    uint32 FirstRiderStop{};
+    uint32 RiderStopCount{};
+};
+
+// Destination floor of passengers in car or waiting for car
+struct AllocationStop
+{
+    uint32 FloorIndex{};
+    uint32 Count{};
+};
+
+// Hall call served by one car
+struct AllocationCall
+{
+    uint32 FloorIndex{};
+    MovementType Direction{ MovementType::Up };
+
+    // Count of waiting passengers
+    uint32 Count{};
+
+    // Car serving call now
+    uint32 CarIndex{};
+
+    // Cars stopping on call floor and passenger destinations. Bit of car index
+    uint64 CarMask{ ~uint64(0) };
+
+    // Range of passenger destinations in AllocationProblem::DestinationStops
+    uint32 FirstDestinationStop{};
+    uint32 DestinationStopCount{};
+};
+
+// Snapshot of group for call reallocation. Search works on snapshot, so cars are never locked by workers
+struct WH_CTRL_API AllocationProblem
+{
+    // Remove all cars and calls. Keep allocated memory
+    void Clear();
+
+    EtaTiming Timing;
+    std::vector<AllocationCar> Cars;
+    std::vector<AllocationStop> RiderStops;
+    std::vector<AllocationCall> Calls;
+    std::vector<AllocationStop> DestinationStops;
+};
+
+// Hall call moved to other car
+struct AllocationMove
+{
+    uint32 FloorIndex{};
+    MovementType Direction{ MovementType::Up };
+    uint32 FromCar{};
+    uint32 ToCar{};
+};
+
+// Improved assignment of hall calls
+struct AllocationPlan
+{
+    std::vector<AllocationMove> Moves;
+
+    // Cost of snapshot assignment and of plan in passenger journey milliseconds
+    uint64 InitialCost{};
+    uint64 Cost{};
+
+    // Search iterations of all workers
+    uint64 Iterations{};
+};
+
+// Options of call reallocation
+struct WH_CTRL_API CallAllocatorConfig
+{
+    // Load reallocation options from config
+    static CallAllocatorConfig LoadFromConfig();
+
+    // Time between searches. 0 - reallocation disabled
+    Milliseconds Interval{};
+
+    // Time limit of one search
+    Microseconds Budget{ 2ms };
+
+    // Search iterations of one chain instead of time limit. Plan doesn't depend on machine speed. 0 - use Budget
+    uint64 Iterations{};
+
+    // Count of annealing chains. 0 - one per worker
+    std::size_t ChainCount{};
+
+    // Count of workers. 0 - use hardware concurrency
+    std::size_t ThreadCount{};
+
+    // Run all chains on caller thread in Start without workers. Used by virtual time simulation
+    bool IsInline{};
+
+    // Base seed of worker chains
+    uint64 Seed{};
+};
+
+// Periodic re-optimization of hall call to car assignment.
+// Workers run independent simulated annealing chains over snapshot until deadline, iteration limit or cancel.
+// With iteration limit and fixed chain count same seed and snapshot give same plan.
+// Last finished worker publishes best plan with one atomic store. Owner takes plan without blocking.
+class WH_CTRL_API CallAllocator
+{
+public:
+    explicit CallAllocator(CallAllocatorConfig const& config);
+    ~CallAllocator();
+
+    CallAllocator(CallAllocator const&) = delete;
+    CallAllocator& operator=(CallAllocator const&) = delete;
+
+    // Start search over problem. Problem is swapped with previous one, so buffers are reused.
+    // Never blocks unless inline, then plan is published before return. Returns false if previous search is running
+    bool Start(AllocationProblem& problem);
+
+    // Stop running search at next deadline check. Best plan found so far is published
+    inline void Cancel() { _cancel.store(true, std::memory_order_relaxed); }
+
+    // Take published plan. Never blocks. nullptr - no new plan
+    std::shared_ptr<AllocationPlan const> TakePlan();
+
+    // Block until running search is finished and take its plan. Used by virtual time simulation
+    std::shared_ptr<AllocationPlan const> WaitPlan();
+
+    [[nodiscard]] inline bool IsRunning() const { return _running.load(std::memory_order_acquire); }
+
+    [[nodiscard]] inline CallAllocatorConfig const& GetConfig() const { return _config; }
+
+    // Cost of assignment in passenger journey milliseconds. assignment[i] is car of call i
+    static uint64 GetCost(AllocationProblem const& problem, std::span<uint32 const> assignment);
+
+private:
+    // Best assignment of one chain
+    struct ChainResult
+    {
+        std::vector<uint32> Assignment;
+        uint64 Cost{};
+        uint64 Iterations{};
+    };
+
+    // Run one annealing chain until deadline or iteration limit
+    void RunChain(std::size_t chainIndex);
+
+    // Publish best plan if chain is last one
+    void FinishChain();
+
+    CallAllocatorConfig _config;
+
+    // Workers of chains. nullptr - inline search
+    std::unique_ptr<Warhead::ThreadPool> _pool;
+
+    // Snapshot of running search. Read only for workers
+    AllocationProblem _problem;
+    uint64 _initialCost{};
+
+    std::vector<ChainResult> _results;
+    std::chrono::steady_clock::time_point _deadline;
+    uint64 _searchCount{};
+
+    std::atomic<std::size_t> _runningChains{};
+    std::atomic<bool> _running{};
+    std::atomic<bool> _cancel{};
+
+    // Last published plan
+    std::atomic<std::shared_ptr<AllocationPlan const>> _plan;
+};
+
+#endif
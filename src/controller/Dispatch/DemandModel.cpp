@@ -0,0 +1,198 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "DemandModel.h"
+#include "Config.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    // Rebase weights when arrival weight is over 2^REBASE_EXPONENT
+    constexpr double REBASE_EXPONENT = 256.0;
+
+    // Day length for time-of-day buckets
+    constexpr Milliseconds DAY = 24h;
+
+    // Min decrease of expected distance to next call in floors. Smaller gain isn't worth the trip
+    constexpr double MIN_PARKING_GAIN = 1.0;
+}
+
+/*static*/ DemandModelConfig DemandModelConfig::LoadFromConfig()
+{
+    DemandModelConfig config;
+    DemandModelConfig const defaultConfig;
+
+    config.BucketDuration = Minutes(sConfigMgr->GetOption<uint32>("Dispatch.Parking.BucketMinutes", static_cast<uint32>(std::chrono::duration_cast<Minutes>(defaultConfig.BucketDuration).count())));
+    config.HalfLife = Hours(sConfigMgr->GetOption<uint32>("Dispatch.Parking.HalfLifeHours", static_cast<uint32>(std::chrono::duration_cast<Hours>(defaultConfig.HalfLife).count())));
+
+    if (config.BucketDuration <= 0ms || config.BucketDuration > DAY)
+        config.BucketDuration = defaultConfig.BucketDuration;
+
+    if (config.HalfLife <= 0ms)
+        config.HalfLife = defaultConfig.HalfLife;
+
+    return config;
+}
+
+DemandModel::DemandModel(BuildingGeometry const& geometry /*= {}*/, DemandModelConfig const& config /*= {}*/) :
+    _geometry(geometry), _config(config)
+{
+    _bucketCount = static_cast<uint32>((DAY + _config.BucketDuration - 1ms) / _config.BucketDuration);
+    _weights.assign(static_cast<std::size_t>(_bucketCount) * _geometry.GetFloorCount(), 0.0);
+    _scores.resize(_geometry.GetFloorCount());
+    _coverDistance.resize(_geometry.GetFloorCount());
+}
+
+void DemandModel::AddArrival(Milliseconds time, Floor floor)
+{
+    if (!_geometry.IsValidFloor(floor))
+        return;
+
+    auto weight = GetArrivalWeight(time);
+    if (weight > std::exp2(REBASE_EXPONENT))
+    {
+        Rebase(time);
+        weight = 1.0;
+    }
+
+    _weights[static_cast<std::size_t>(GetBucket(time)) * _geometry.GetFloorCount() + _geometry.GetFloorIndex(floor)] += weight;
+    _arrivalCount++;
+}
+
+double DemandModel::GetDemandShare(Milliseconds time, Floor floor) const
+{
+    if (!_geometry.IsValidFloor(floor))
+        return 0.0;
+
+    FillScores(time);
+
+    double total{};
+    for (auto score : _scores)
+        total += score;
+
+    return total > 0.0 ? _scores[_geometry.GetFloorIndex(floor)] / total : 0.0;
+}
+
+Floor DemandModel::GetParkingFloor(Milliseconds time, Floor currentFloor, std::span<Floor const> otherCarFloors, FloorSet const* servedFloors /*= nullptr*/) const
+{
+    FillScores(time);
+
+    auto const floorCount = _geometry.GetFloorCount();
+    auto isServed = [servedFloors](uint32 floorIndex) { return !servedFloors || servedFloors->Test(floorIndex); };
+
+    // Calls on floors of other banks are served by their cars
+    if (servedFloors)
+        for (uint32 floorIndex{}; floorIndex < floorCount; floorIndex++)
+            if (!isServed(floorIndex))
+                _scores[floorIndex] = 0.0;
+
+    if (std::all_of(_scores.begin(), _scores.end(), [](double score) { return score <= 0.0; }))
+        return isServed(_geometry.GetFloorIndex(_geometry.LobbyFloor)) || !_geometry.IsValidFloor(currentFloor) ? _geometry.LobbyFloor : currentFloor;
+
+    // Distance from every floor to nearest other car. Car farther than building never covers call
+    std::fill(_coverDistance.begin(), _coverDistance.end(), floorCount);
+
+    for (auto carFloor : otherCarFloors)
+    {
+        if (!_geometry.IsValidFloor(carFloor))
+            continue;
+
+        auto carIndex = _geometry.GetFloorIndex(carFloor);
+        for (uint32 floorIndex{}; floorIndex < floorCount; floorIndex++)
+            _coverDistance[floorIndex] = std::min(_coverDistance[floorIndex], carIndex > floorIndex ? carIndex - floorIndex : floorIndex - carIndex);
+    }
+
+    // Expected distance to next call from candidate floor, nearest of candidate and other cars serves call
+    auto getCost = [this, floorCount](uint32 candidate, double limit)
+    {
+        double cost{};
+
+        for (uint32 floorIndex{}; floorIndex < floorCount && cost < limit; floorIndex++)
+        {
+            auto distance = std::min(_coverDistance[floorIndex], candidate > floorIndex ? candidate - floorIndex : floorIndex - candidate);
+            cost += _scores[floorIndex] * distance;
+        }
+
+        return cost;
+    };
+
+    uint32 bestFloor{};
+    double bestCost{ std::numeric_limits<double>::max() };
+
+    for (uint32 candidate{}; candidate < floorCount; candidate++)
+    {
+        if (!isServed(candidate))
+            continue;
+
+        auto cost = getCost(candidate, bestCost);
+        if (cost < bestCost)
+        {
+            bestCost = cost;
+            bestFloor = candidate;
+        }
+    }
+
+    if (!_geometry.IsValidFloor(currentFloor))
+        return _geometry.GetFloorByIndex(bestFloor);
+
+    double totalScore{};
+    for (auto score : _scores)
+        totalScore += score;
+
+    auto currentCost = getCost(_geometry.GetFloorIndex(currentFloor), std::numeric_limits<double>::max());
+    return (currentCost - bestCost) / totalScore < MIN_PARKING_GAIN ? currentFloor : _geometry.GetFloorByIndex(bestFloor);
+}
+
+uint32 DemandModel::GetBucket(Milliseconds time) const
+{
+    auto timeOfDay = time % DAY;
+    if (timeOfDay < 0ms)
+        timeOfDay += DAY;
+
+    return static_cast<uint32>(timeOfDay / _config.BucketDuration);
+}
+
+double DemandModel::GetArrivalWeight(Milliseconds time) const
+{
+    return std::exp2(static_cast<double>((time - _epoch).count()) / static_cast<double>(_config.HalfLife.count()));
+}
+
+void DemandModel::Rebase(Milliseconds time)
+{
+    auto scale = 1.0 / GetArrivalWeight(time);
+
+    for (auto& weight : _weights)
+        weight *= scale;
+
+    _epoch = time;
+}
+
+void DemandModel::FillScores(Milliseconds time) const
+{
+    auto const floorCount = _geometry.GetFloorCount();
+    auto bucket = GetBucket(time);
+
+    // Calls of next bucket come soon. Learned on previous days
+    auto current = _weights.begin() + static_cast<std::ptrdiff_t>(bucket) * floorCount;
+    auto next = _weights.begin() + static_cast<std::ptrdiff_t>((bucket + 1) % _bucketCount) * floorCount;
+
+    for (uint32 floorIndex{}; floorIndex < floorCount; floorIndex++)
+        _scores[floorIndex] = current[floorIndex] + next[floorIndex];
+}
@@ -0,0 +1,98 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_DEMAND_MODEL_H_
+#define WARHEAD_DEMAND_MODEL_H_
+
+#include "Building.h"
+#include "Duration.h"
+#include "FloorSet.h"
+#include <span>
+#include <vector>
+
+// Options of learned hall call demand
+struct WH_CTRL_API DemandModelConfig
+{
+    // Load demand options from config
+    static DemandModelConfig LoadFromConfig();
+
+    // Length of time-of-day bucket
+    Milliseconds BucketDuration{ 15min };
+
+    // Time after which arrival weight is halved
+    Milliseconds HalfLife{ 72h };
+};
+
+// Online model of hall call arrivals per floor and time-of-day bucket with exponentially decayed weights.
+// Instead of decaying every cell, new arrivals get weight growing as 2^(time / half life), so all cells
+// are decayed by same factor and can be compared directly. Arrival update is O(1).
+// Not thread safe: arrivals and parking queries must come from one thread
+class WH_CTRL_API DemandModel
+{
+public:
+    explicit DemandModel(BuildingGeometry const& geometry = {}, DemandModelConfig const& config = {});
+    ~DemandModel() = default;
+
+    // Add hall call on floor at time
+    void AddArrival(Milliseconds time, Floor floor);
+
+    // Expected share of hall calls coming from floor in time bucket and next one. 0 if nothing learned
+    [[nodiscard]] double GetDemandShare(Milliseconds time, Floor floor) const;
+
+    // Floor for idle car minimizing expected distance to next hall call. Floors of other idle cars
+    // already cover calls near them. Car stays on current floor if parking saves less than one floor on average.
+    // Lobby if nothing learned. Car of zoned bank parks and covers calls only on served floors, nullptr - all floors.
+    // O(floors^2), called only for idle car
+    [[nodiscard]] Floor GetParkingFloor(Milliseconds time, Floor currentFloor, std::span<Floor const> otherCarFloors, FloorSet const* servedFloors = nullptr) const;
+
+    // Count of added arrivals
+    [[nodiscard]] inline uint64 GetArrivalCount() const { return _arrivalCount; }
+
+    // Index of time-of-day bucket
+    [[nodiscard]] uint32 GetBucket(Milliseconds time) const;
+
+    [[nodiscard]] inline BuildingGeometry const& GetGeometry() const { return _geometry; }
+
+private:
+    // Weight of arrival at time relative to model epoch
+    [[nodiscard]] double GetArrivalWeight(Milliseconds time) const;
+
+    // Scale all weights down and move epoch to time, so arrival weight stays in double range
+    void Rebase(Milliseconds time);
+
+    // Fill _scores with weights of floors in bucket of time and next bucket
+    void FillScores(Milliseconds time) const;
+
+    BuildingGeometry _geometry;
+    DemandModelConfig _config;
+    uint32 _bucketCount{};
+
+    // Decayed arrival weights, bucket major
+    std::vector<double> _weights;
+
+    // Time of weight 1.0
+    Milliseconds _epoch{};
+
+    uint64 _arrivalCount{};
+
+    // Scratch buffers of parking query
+    mutable std::vector<double> _scores;
+    mutable std::vector<uint32> _coverDistance;
+};
+
+#endif
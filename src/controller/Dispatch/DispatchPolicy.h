@@ -0,0 +1,128 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_DISPATCH_POLICY_H_
+#define WARHEAD_DISPATCH_POLICY_H_
+
+#include "Building.h"
+#include "PassengerBuckets.h"
+#include <concepts>
+#include <string_view>
+
+// Elevator command
+enum class MovementType : uint8
+{
+    Up,
+    Down
+};
+
+// Car state for next stop decision
+struct DispatchState
+{
+    BuildingGeometry const& Geometry;
+    Floor CurrentFloor{};
+    MovementType Movement{};
+
+    // Records of all passengers of car
+    PassengerStore const& Passengers;
+
+    // Passengers in car by destination floor and waiting by current floor.
+    // Floors of these buckets are car calls, up hall calls and down hall calls
+    PassengerBuckets const& Riders;
+    PassengerBuckets const& WaitingUp;
+    PassengerBuckets const& WaitingDown;
+
+    // Car can't take more passengers. Full car bypasses hall calls and stops only for riders
+    bool IsFull{};
+
+    // Lowest stop floor index >= from. Full car check is one branch, so bypass costs nothing
+    [[nodiscard]] inline uint32 FindNextStop(uint32 from) const
+    {
+        return IsFull ? FloorSet::FindNext(from, Riders.GetFloors()) : FloorSet::FindNext(from, Riders.GetFloors(), WaitingUp.GetFloors(), WaitingDown.GetFloors());
+    }
+
+    // Highest stop floor index <= from
+    [[nodiscard]] inline uint32 FindPrevStop(uint32 from) const
+    {
+        return IsFull ? FloorSet::FindPrev(from, Riders.GetFloors()) : FloorSet::FindPrev(from, Riders.GetFloors(), WaitingUp.GetFloors(), WaitingDown.GetFloors());
+    }
+};
+
+// Selects next stop of car. Policy is used as template parameter, so decision is inlined in caller
+template<typename T>
+concept DispatchPolicy = requires(T const& policy, DispatchState const& state)
+{
+    { T::Name } -> std::convertible_to<std::string_view>;
+    { policy.SelectNextFloor(state) } -> std::same_as<Floor>;
+};
+
+// Nearest requested floor in movement direction, otherwise nearest in opposite direction (LOOK)
+struct NearestInDirectionPolicy
+{
+    static constexpr std::string_view Name = "NearestInDirection";
+
+    Floor SelectNextFloor(DispatchState const& state) const
+    {
+        auto floorIndex = state.Geometry.GetFloorIndex(state.CurrentFloor);
+
+        // Nearest requested floors above and below elevator
+        auto nextFloorUp = state.FindNextStop(floorIndex + 1);
+        auto nextFloorDown = floorIndex ? state.FindPrevStop(floorIndex - 1) : FloorSet::npos;
+
+        // Keep movement while have requests in this direction, otherwise turn around
+        if (state.Movement == MovementType::Down)
+            std::swap(nextFloorUp, nextFloorDown);
+
+        if (nextFloorUp != FloorSet::npos)
+            return state.Geometry.GetFloorByIndex(nextFloorUp);
+
+        if (nextFloorDown != FloorSet::npos)
+            return state.Geometry.GetFloorByIndex(nextFloorDown);
+
+        // Requests only on current floor
+        return state.CurrentFloor;
+    }
+};
+
+// Nearest requested floor in any direction. Shorter trips, but far floors can wait long
+struct NearestCallPolicy
+{
+    static constexpr std::string_view Name = "NearestCall";
+
+    Floor SelectNextFloor(DispatchState const& state) const
+    {
+        auto floorIndex = state.Geometry.GetFloorIndex(state.CurrentFloor);
+
+        auto nextFloorUp = state.FindNextStop(floorIndex + 1);
+        auto nextFloorDown = floorIndex ? state.FindPrevStop(floorIndex - 1) : FloorSet::npos;
+
+        if (nextFloorUp == FloorSet::npos && nextFloorDown == FloorSet::npos)
+            return state.CurrentFloor;
+
+        if (nextFloorDown == FloorSet::npos || (nextFloorUp != FloorSet::npos && nextFloorUp - floorIndex < floorIndex - nextFloorDown))
+            return state.Geometry.GetFloorByIndex(nextFloorUp);
+
+        if (nextFloorUp == FloorSet::npos || floorIndex - nextFloorDown < nextFloorUp - floorIndex)
+            return state.Geometry.GetFloorByIndex(nextFloorDown);
+
+        // Same distance. Keep movement
+        return state.Geometry.GetFloorByIndex(state.Movement == MovementType::Up ? nextFloorUp : nextFloorDown);
+    }
+};
+
+#endif
@@ -0,0 +1,78 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "DispatchPolicyRegistry.h"
+#include "Config.h"
+#include "Log.h"
+#include <utility>
+
+namespace
+{
+    template<std::size_t... Indexes>
+    std::optional<AnyDispatchPolicy> CreatePolicy(std::string_view name, std::index_sequence<Indexes...>)
+    {
+        std::optional<AnyDispatchPolicy> policy;
+        ((std::variant_alternative_t<Indexes, AnyDispatchPolicy>::Name == name ? policy.emplace(std::in_place_index<Indexes>), true : false) || ...);
+        return policy;
+    }
+
+    template<std::size_t... Indexes>
+    std::vector<std::string_view> GetPolicyNames(std::index_sequence<Indexes...>)
+    {
+        return { std::variant_alternative_t<Indexes, AnyDispatchPolicy>::Name... };
+    }
+
+    constexpr auto POLICY_INDEXES = std::make_index_sequence<std::variant_size_v<AnyDispatchPolicy>>{};
+}
+
+/*static*/ std::optional<AnyDispatchPolicy> DispatchPolicyRegistry::Create(std::string_view name)
+{
+    return CreatePolicy(name, POLICY_INDEXES);
+}
+
+/*static*/ AnyDispatchPolicy DispatchPolicyRegistry::LoadFromConfig()
+{
+    auto name = sConfigMgr->GetOption<std::string>("Dispatch.Policy", std::string{ NearestInDirectionPolicy::Name });
+
+    auto policy = Create(name);
+    if (!policy)
+    {
+        std::string names;
+        for (auto policyName : GetNames())
+            names.append(names.empty() ? "" : ", ").append(policyName);
+
+        LOG_ERROR("dispatch", "> Dispatch: Unknown policy '{}'. Use {}. Known policies: {}", name, NearestInDirectionPolicy::Name, names);
+        return NearestInDirectionPolicy{};
+    }
+
+    if (auto planner = std::get_if<BranchAndBoundPolicy>(&*policy))
+        planner->Budget = Microseconds(sConfigMgr->GetOption<uint32>("Dispatch.PlannerBudget", static_cast<uint32>(planner->Budget.count())));
+
+    LOG_INFO("dispatch", "> Dispatch: Use {} policy", name);
+    return *policy;
+}
+
+/*static*/ std::vector<std::string_view> DispatchPolicyRegistry::GetNames()
+{
+    return GetPolicyNames(POLICY_INDEXES);
+}
+
+/*static*/ std::string_view DispatchPolicyRegistry::GetName(AnyDispatchPolicy const& policy)
+{
+    return std::visit([](auto const& value) { return std::decay_t<decltype(value)>::Name; }, policy);
+}
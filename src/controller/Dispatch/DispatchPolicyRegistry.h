@@ -0,0 +1,49 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_DISPATCH_POLICY_REGISTRY_H_
+#define WARHEAD_DISPATCH_POLICY_REGISTRY_H_
+
+#include "DispatchPolicy.h"
+#include "RoutePlanner.h"
+#include <optional>
+#include <variant>
+#include <vector>
+
+// Any known policy. Selected once at runtime. Real-time car visits it once per next floor decision in Update,
+// simulation visits it once per run and instantiates its event loop for every policy
+using AnyDispatchPolicy = std::variant<NearestInDirectionPolicy, NearestCallPolicy, BranchAndBoundPolicy>;
+
+// Find known policies by config name
+class WH_CTRL_API DispatchPolicyRegistry
+{
+public:
+    // Policy with name. Empty if name is unknown
+    static std::optional<AnyDispatchPolicy> Create(std::string_view name);
+
+    // Policy from config option Dispatch.Policy. Default policy if name is unknown
+    static AnyDispatchPolicy LoadFromConfig();
+
+    // Names of all known policies
+    static std::vector<std::string_view> GetNames();
+
+    // Name of policy
+    static std::string_view GetName(AnyDispatchPolicy const& policy);
+};
+
+#endif
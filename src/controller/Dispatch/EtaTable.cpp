@@ -0,0 +1,91 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "EtaTable.h"
+#include <algorithm>
+
+void EtaTable::Build(ElevatorSnapshot const& snapshot, BuildingGeometry const& geometry, EtaTiming const& timing)
+{
+    auto const floorCount = geometry.GetFloorCount();
+    auto const travel = static_cast<uint32>(timing.FloorTravelTime.count());
+    auto const stop = static_cast<uint32>(timing.StopTime.count());
+    bool const isUp = snapshot.Movement == MovementType::Up;
+
+    _up.resize(floorCount);
+    _down.resize(floorCount);
+    _stopPrefix.resize(floorCount + 1);
+    _version = snapshot.Version;
+
+    // Work in movement coordinates: car always moves forward to higher positions
+    auto toPosition = [&](uint32 floorIndex) { return isUp ? floorIndex : floorCount - 1 - floorIndex; };
+
+    // Forward calls go in car movement direction, backward calls in opposite
+    auto& forward = isUp ? _up : _down;
+    auto& backward = isUp ? _down : _up;
+
+    uint32 const car = toPosition(geometry.GetFloorIndex(snapshot.CurrentFloor));
+    uint32 lowest = car;
+    uint32 highest = car;
+
+    _stopPrefix[0] = 0;
+
+    for (uint32 position{}; position < floorCount; position++)
+    {
+        auto floorIndex = isUp ? position : floorCount - 1 - position;
+        bool isStop = snapshot.Riders[floorIndex] || (!snapshot.IsFull && (snapshot.WaitingUp[floorIndex] || snapshot.WaitingDown[floorIndex]));
+
+        _stopPrefix[position + 1] = _stopPrefix[position] + (isStop ? 1 : 0);
+
+        if (isStop)
+        {
+            lowest = std::min(lowest, position);
+            highest = std::max(highest, position);
+        }
+    }
+
+    // Count of stops strictly between positions
+    auto stopsBetween = [this](uint32 from, uint32 to) { return to > from + 1 ? _stopPrefix[to] - _stopPrefix[from + 1] : 0; };
+
+    // Arrival to position ahead of car without turning around
+    auto ahead = [&](uint32 position) { return (position - car) * travel + stopsBetween(car, position) * stop; };
+
+    // Car turned around at highest stop
+    uint32 const turnTime = ahead(highest) + (highest > car ? stop : 0);
+
+    // Car turned around again at lowest stop
+    uint32 const secondTurnTime = turnTime + (highest - lowest) * travel + stopsBetween(lowest, car) * stop + (lowest < car ? stop : 0);
+
+    for (uint32 floorIndex{}; floorIndex < floorCount; floorIndex++)
+    {
+        auto position = toPosition(floorIndex);
+
+        // Forward call: pick up on the way or after two turns
+        if (position >= car)
+            forward[floorIndex] = ahead(position);
+        else if (position <= lowest)
+            forward[floorIndex] = turnTime + (highest - position) * travel + stopsBetween(position, car) * stop;
+        else
+            forward[floorIndex] = secondTurnTime + (position - lowest) * travel;
+
+        // Backward call: car goes up to call or highest stop, then comes back
+        if (position >= highest)
+            backward[floorIndex] = ahead(position);
+        else
+            backward[floorIndex] = turnTime + (highest - position) * travel + (position < car ? stopsBetween(position, car) * stop : 0);
+    }
+}
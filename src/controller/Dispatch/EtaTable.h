@@ -0,0 +1,71 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_ETA_TABLE_H_
+#define WARHEAD_ETA_TABLE_H_
+
+#include "Duration.h"
+#include "ElevatorSnapshot.h"
+#include <limits>
+#include <vector>
+
+// Time model for estimated time of arrival
+struct EtaTiming
+{
+    // Car travel time between two adjacent floors
+    Milliseconds FloorTravelTime{ 1500ms };
+
+    // Time of one stop: doors opening, dwell and doors closing
+    Milliseconds StopTime{ 7s };
+};
+
+// Estimated time of car arrival to hall call on every floor in both directions.
+// Car follows collective sweep: serves stops in movement direction, turns around at last stop.
+// Table is built in O(floors) and rebuilt only when car state version changes
+class WH_CTRL_API EtaTable
+{
+public:
+    static constexpr uint64 VERSION_NONE = std::numeric_limits<uint64>::max();
+
+    // Build table from published car snapshot. Car is not locked
+    void Build(ElevatorSnapshot const& snapshot, BuildingGeometry const& geometry, EtaTiming const& timing);
+
+    // Table was built for car state version
+    [[nodiscard]] inline bool IsValid(uint64 version) const { return _version == version; }
+
+    // Drop table. Next use rebuilds it
+    inline void Invalidate() { _version = VERSION_NONE; }
+
+    // Time until car arrives to hall call on floor for passenger going in direction
+    [[nodiscard]] inline Milliseconds Get(uint32 floorIndex, MovementType direction) const
+    {
+        return Milliseconds(direction == MovementType::Up ? _up[floorIndex] : _down[floorIndex]);
+    }
+
+private:
+    // ETA of hall calls by floor index in ms
+    std::vector<uint32> _up;
+    std::vector<uint32> _down;
+
+    // Count of stops below floor index in car movement coordinates
+    std::vector<uint32> _stopPrefix;
+
+    uint64 _version{ VERSION_NONE };
+};
+
+#endif
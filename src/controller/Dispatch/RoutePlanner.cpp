@@ -0,0 +1,330 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "RoutePlanner.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <span>
+
+namespace
+{
+    constexpr std::size_t MAX_STOPS = BranchAndBoundPolicy::MAX_PLAN_STOPS;
+
+    // Search nodes between clock checks
+    constexpr uint32 BUDGET_CHECK_INTERVAL = 64;
+
+    using StopCounts = std::array<uint32, MAX_STOPS>;
+
+    // Floors of route and passengers served on them
+    struct RoutePlan
+    {
+        // Add floor if need. Returns stop index or MAX_STOPS if plan is full
+        std::size_t AddStop(uint32 floorIndex)
+        {
+            for (std::size_t i{}; i < StopCount; i++)
+                if (Floors[i] == floorIndex)
+                    return i;
+
+            if (StopCount == MAX_STOPS)
+                return MAX_STOPS;
+
+            Floors[StopCount] = floorIndex;
+            return StopCount++;
+        }
+
+        std::array<uint32, MAX_STOPS> Floors{};
+        std::size_t StopCount{};
+
+        // Passengers in car by destination stop
+        StopCounts Riders{};
+
+        // Waiting passengers by pickup stop and destination stop
+        std::array<StopCounts, MAX_STOPS> Pickups{};
+
+        // Count of waiting passengers by pickup stop
+        StopCounts PickupCounts{};
+    };
+
+    // Depth first search of stop orders. Passenger delivered at stop visited after pickup,
+    // otherwise car comes back for him after last stop
+    class RouteSearch
+    {
+    public:
+        RouteSearch(RoutePlan const& plan, uint32 start, std::size_t requestCount, EtaTiming const& timing, Microseconds budget) :
+            _plan(plan), _start(start), _requestCount(requestCount), _inCar(plan.Riders),
+            _travel(static_cast<uint64>(timing.FloorTravelTime.count())), _stop(static_cast<uint64>(timing.StopTime.count())),
+            _deadline(std::chrono::steady_clock::now() + budget) { }
+
+        // Search order better than initial. Returns first stop of best order
+        std::size_t Run(std::span<uint8 const> initialOrder)
+        {
+            _bestCost = GetCost(initialOrder);
+            _bestFirst = initialOrder.front();
+
+            Search(0, _start, 0, 0, 0);
+            return _bestFirst;
+        }
+
+    private:
+        static inline uint64 Distance(uint32 from, uint32 to) { return from > to ? from - to : to - from; }
+
+        // Visit stop: deliver passengers in car, pick up waiting. Returns added cost
+        uint64 Visit(std::size_t index, uint64 arrival)
+        {
+            uint64 cost = arrival * _inCar[index];
+            _inCar[index] = 0;
+            _visited |= 1u << index;
+
+            for (std::size_t destination{}; destination < _plan.StopCount; destination++)
+            {
+                auto count = _plan.Pickups[index][destination];
+                if (!count)
+                    continue;
+
+                if (_visited & (1u << destination))
+                    _late[destination] += count;
+                else
+                    _inCar[destination] += count;
+            }
+
+            return cost;
+        }
+
+        void Unvisit(std::size_t index, uint32 delivered)
+        {
+            for (std::size_t destination{}; destination < _plan.StopCount; destination++)
+            {
+                auto count = _plan.Pickups[index][destination];
+                if (!count)
+                    continue;
+
+                if (_visited & (1u << destination))
+                    _late[destination] -= count;
+                else
+                    _inCar[destination] -= count;
+            }
+
+            _visited &= ~(1u << index);
+            _inCar[index] = delivered;
+        }
+
+        // Cost of passengers left after last stop: car comes back for every destination
+        uint64 GetLateCost(uint32 position, uint64 time) const
+        {
+            uint64 cost{};
+
+            for (std::size_t i{}; i < _plan.StopCount; i++)
+                if (_late[i])
+                    cost += (time + Distance(position, _plan.Floors[i]) * _travel) * _late[i];
+
+            return cost;
+        }
+
+        uint64 GetCost(std::span<uint8 const> order)
+        {
+            uint64 time{}, cost{};
+            auto position = _start;
+
+            std::array<uint32, MAX_STOPS> delivered{};
+
+            for (auto index : order)
+            {
+                time += Distance(position, _plan.Floors[index]) * _travel;
+                delivered[index] = _inCar[index];
+                cost += Visit(index, time);
+                time += _stop;
+                position = _plan.Floors[index];
+            }
+
+            cost += GetLateCost(position, time);
+
+            for (auto i = order.size(); i > 0; i--)
+                Unvisit(order[i - 1], delivered[order[i - 1]]);
+
+            return cost;
+        }
+
+        void Search(std::size_t depth, uint32 position, uint64 time, uint64 cost, std::size_t first)
+        {
+            if (_stopped)
+                return;
+
+            if (depth == _plan.StopCount)
+            {
+                cost += GetLateCost(position, time);
+
+                if (cost < _bestCost)
+                {
+                    _bestCost = cost;
+                    _bestFirst = first;
+                }
+
+                return;
+            }
+
+            if (++_nodeCount % BUDGET_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= _deadline)
+            {
+                _stopped = true;
+                return;
+            }
+
+            // Lower bound: every remaining stop reached straight from current position
+            uint64 bound = cost + GetLateCost(position, time);
+            for (std::size_t i{}; i < _plan.StopCount; i++)
+                if (!(_visited & (1u << i)))
+                    bound += (time + Distance(position, _plan.Floors[i]) * _travel) * (_inCar[i] + _plan.PickupCounts[i]);
+
+            if (bound >= _bestCost)
+                return;
+
+            // Nearest stops first find good orders early
+            std::array<uint8, MAX_STOPS> candidates{};
+            std::size_t candidateCount{};
+
+            auto const stopCount = depth ? _plan.StopCount : _requestCount;
+
+            for (std::size_t i{}; i < stopCount; i++)
+                if (!(_visited & (1u << i)))
+                    candidates[candidateCount++] = static_cast<uint8>(i);
+
+            std::sort(candidates.begin(), candidates.begin() + candidateCount, [this, position](uint8 left, uint8 right)
+            {
+                return Distance(position, _plan.Floors[left]) < Distance(position, _plan.Floors[right]);
+            });
+
+            for (std::size_t i{}; i < candidateCount; i++)
+            {
+                auto index = candidates[i];
+                auto floorIndex = _plan.Floors[index];
+                auto arrival = time + Distance(position, floorIndex) * _travel;
+                auto delivered = _inCar[index];
+
+                auto visitCost = Visit(index, arrival);
+                Search(depth + 1, floorIndex, arrival + _stop, cost + visitCost, depth ? first : index);
+                Unvisit(index, delivered);
+            }
+        }
+
+        RoutePlan const& _plan;
+        uint32 _start{};
+
+        // Stops with riders or waiting passengers. Only they can be first stop
+        std::size_t _requestCount{};
+
+        // Passengers in car by destination stop
+        StopCounts _inCar{};
+
+        // Passengers picked up after their destination stop was visited
+        StopCounts _late{};
+
+        uint64 _travel{};
+        uint64 _stop{};
+        std::chrono::steady_clock::time_point _deadline;
+
+        uint32 _visited{};
+        uint64 _nodeCount{};
+        bool _stopped{};
+
+        uint64 _bestCost{};
+        std::size_t _bestFirst{};
+    };
+}
+
+Floor BranchAndBoundPolicy::SelectNextFloor(DispatchState const& state) const
+{
+    auto const& geometry = state.Geometry;
+
+    auto start = geometry.GetFloorIndex(state.CurrentFloor);
+
+    // Collective sweep order: stops ahead in direction, then stops behind in opposite direction
+    RoutePlan plan;
+
+    // Next requested floor from floor in direction
+    auto findNext = [&](uint32 floorIndex, bool isUp)
+    {
+        if (isUp)
+            return state.FindNextStop(floorIndex + 1);
+
+        return floorIndex ? state.FindPrevStop(floorIndex - 1) : FloorSet::npos;
+    };
+
+    auto addStops = [&](bool isUp)
+    {
+        for (auto floorIndex = findNext(start, isUp); floorIndex != FloorSet::npos; floorIndex = findNext(floorIndex, isUp))
+        {
+            auto index = plan.AddStop(floorIndex);
+            if (index == MAX_PLAN_STOPS)
+                return false;
+
+            plan.Riders[index] = state.Riders.GetCount(floorIndex);
+        }
+
+        return true;
+    };
+
+    bool isUp = state.Movement == MovementType::Up;
+
+    // Too many stops for search in budget
+    if (!addStops(isUp) || !addStops(!isUp))
+        return NearestInDirectionPolicy{}.SelectNextFloor(state);
+
+    auto const requestCount = plan.StopCount;
+
+    // Requests only on current floor
+    if (!requestCount)
+        return state.CurrentFloor;
+
+    if (requestCount == 1)
+        return geometry.GetFloorByIndex(plan.Floors[0]);
+
+    // Destinations of waiting passengers are stops too. Full car picks up nobody
+    bool isPlanFull{};
+
+    for (std::size_t pickup{}; pickup < requestCount && !state.IsFull; pickup++)
+    {
+        auto addPickup = [&](PassengerId id)
+        {
+            auto destination = plan.AddStop(geometry.GetFloorIndex(state.Passengers.GetDestination(id)));
+            if (destination == MAX_PLAN_STOPS)
+            {
+                isPlanFull = true;
+                return;
+            }
+
+            plan.Pickups[pickup][destination]++;
+            plan.PickupCounts[pickup]++;
+        };
+
+        state.WaitingUp.ForEach(plan.Floors[pickup], addPickup);
+        state.WaitingDown.ForEach(plan.Floors[pickup], addPickup);
+    }
+
+    if (isPlanFull)
+        return NearestInDirectionPolicy{}.SelectNextFloor(state);
+
+    // Stops were added in sweep order, destinations of waiting passengers after requests
+    std::array<uint8, MAX_PLAN_STOPS> initialOrder{};
+    for (std::size_t i{}; i < plan.StopCount; i++)
+        initialOrder[i] = static_cast<uint8>(i);
+
+    RouteSearch search(plan, start, requestCount, Timing, Budget);
+    auto first = search.Run({ initialOrder.data(), plan.StopCount });
+
+    return geometry.GetFloorByIndex(plan.Floors[first]);
+}
@@ -0,0 +1,45 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_ROUTE_PLANNER_H_
+#define WARHEAD_ROUTE_PLANNER_H_
+
+#include "DispatchPolicy.h"
+#include "EtaTable.h"
+
+// Searches order of pending stops with branch and bound. Minimizes sum of passenger journey times:
+// riders until destination, waiting passengers until pickup and then until their destination.
+// Collective sweep order is initial bound, so plan is never worse than NearestInDirectionPolicy by this cost.
+// Search gives up at time budget and uses best order found
+struct WH_CTRL_API BranchAndBoundPolicy
+{
+    static constexpr std::string_view Name = "BranchAndBound";
+
+    // More stops use collective sweep without search
+    static constexpr std::size_t MAX_PLAN_STOPS = 16;
+
+    Floor SelectNextFloor(DispatchState const& state) const;
+
+    // Time limit of one search
+    Microseconds Budget{ 50us };
+
+    // Travel and stop times of car
+    EtaTiming Timing;
+};
+
+#endif
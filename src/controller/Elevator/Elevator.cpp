@@ -16,59 +16,342 @@
  */
 
 #include "Elevator.h"
+#include "DemandModel.h"
 #include "Log.h"
-#include <vector>
-#include <random>
+#include "MotionProfile.h"
+#include "PassengerTrace.h"
+#include <mutex>
 
-constexpr auto FLOOR_COUNT_MAX = 9;
-constexpr auto FLOOR_COUNT_MIN = 1;
-
-WH_CTRL_API std::atomic<bool> Elevator::_cancel{ false };
-WH_CTRL_API uint8 Elevator::_exitCode = SHUTDOWN_EXIT_CODE;
-
-/*static*/ Elevator* Elevator::instance()
+Elevator::Elevator(BuildingGeometry const& geometry /*= {}*/) :
+    _geometry(geometry), _currentFloor(geometry.LobbyFloor)
 {
-    static Elevator instance;
-    return &instance;
+    ResizeFloorRequests();
+    PublishSnapshot();
 }
 
 void Elevator::Start()
 {
-    std::srand(std::time(nullptr)); //use current time as seed for random generator
-
     AddRandomPassengers(5);
 }
 
 void Elevator::ResetAllPassengers()
 {
-    if (!_elevatorQueue.Empty())
-        _elevatorQueue.Reset();
+    StateGuard guard(*this);
+
+    _passengers.Clear();
+    _riders.Clear();
+    _waitingUp.Clear();
+    _waitingDown.Clear();
+    _waitingDestinationCounts.assign(_waitingDestinationCounts.size(), 0);
+    _waitingDestinations.Clear();
+    _transfers.clear();
+    _load = 0;
+    _deckRiders.fill(0);
+    _deckLoads.fill(0);
+    _isLeftBehind = false;
+    UpdateFull();
+    BumpStateVersion();
+}
+
+void Elevator::ReservePassengers(std::size_t count)
+{
+    std::lock_guard guard(_requestsLock);
+
+    _passengers.Reserve(count);
+}
+
+void Elevator::SetGeometry(BuildingGeometry const& geometry)
+{
+    ResetAllPassengers();
+
+    StateGuard guard(*this);
+
+    _geometry = geometry;
+    _currentFloor = geometry.LobbyFloor;
+    _movementType = MovementType::Up;
+    _isTravelling = false;
+    _busyUntil = _clock;
+
+    ResizeFloorRequests();
+    BumpStateVersion();
+}
+
+void Elevator::SetServedFloors(std::span<Floor const> floors)
+{
+    StateGuard guard(*this);
+
+    FloorSet servedFloors(_geometry.GetFloorCount());
+
+    if (floors.empty())
+    {
+        for (uint32 i{}; i < _geometry.GetFloorCount(); i++)
+            servedFloors.Set(i);
+    }
+    else
+    {
+        for (auto floor : floors)
+        {
+            if (!_geometry.IsValidFloor(floor))
+            {
+                LOG_ERROR("elevator", "Incorrect served floor: {}", floor);
+                continue;
+            }
+
+            servedFloors.Set(_geometry.GetFloorIndex(floor));
+        }
+    }
+
+    // Car without floors can't take passengers and can't stand anywhere
+    if (!servedFloors.Any())
+    {
+        LOG_ERROR("elevator", "No valid served floors. Keep previous served floors");
+        return;
+    }
+
+    _servedFloors = std::move(servedFloors);
+
+    auto currentIndex = _geometry.GetFloorIndex(_currentFloor);
+    if (!_servedFloors.Test(currentIndex))
+    {
+        auto lowestIndex = FloorSet::FindNext(0, _servedFloors);
+        if (lowestIndex != FloorSet::npos)
+            _currentFloor = _geometry.GetFloorByIndex(static_cast<uint32>(lowestIndex));
+    }
+
+    BumpStateVersion();
+}
+
+void Elevator::SetRandomSeed(uint64 seed)
+{
+    _generator.Seed(seed);
+}
 
-    if (!_floorQueue.Empty())
-        _floorQueue.Reset();
+void Elevator::AddPassengerToElevator(Floor floorNeed)
+{
+    if (!Serves(floorNeed))
+    {
+        LOG_ERROR("elevator", "Incorrect floor for elevator passenger: {}", floorNeed);
+        return;
+    }
+
+    StateGuard guard(*this);
+    AddRider(_passengers.Create(_currentFloor, floorNeed, _clock), GetDeck(floorNeed));
+    UpdateFull();
+    BumpStateVersion();
+
+    if (_traceWriter)
+        _traceWriter->Record(_clock, _currentFloor, floorNeed);
+}
+
+void Elevator::AddPassenger(Floor currentFloor, Floor floorNeed, uint16 mass /*= DEFAULT_PASSENGER_MASS*/)
+{
+    AddJourneyPassenger(currentFloor, floorNeed, floorNeed, mass);
 }
 
-void Elevator::AddPassengerToElevator(uint8 floorNeed)
+void Elevator::PostPassenger(Floor currentFloor, Floor floorNeed, uint16 mass /*= DEFAULT_PASSENGER_MASS*/)
 {
-    _elevatorQueue.Add(new ElevatorPassenger(floorNeed));
+    if (_ingress.TryPush({ currentFloor, floorNeed, mass }))
+        return;
+
+    // Update thread is far behind producers. Wait for lock instead of losing call
+    AddPassenger(currentFloor, floorNeed, mass);
 }
 
-void Elevator::AddPassenger(uint8 currentFloor, uint8 floorNeed)
+void Elevator::AddJourneyPassenger(Floor currentFloor, Floor legDestination, Floor finalDestination, uint16 mass /*= DEFAULT_PASSENGER_MASS*/)
 {
-    _floorQueue.Add(new FloorPassenger(currentFloor, floorNeed));
+    if (!IsValidPassenger(currentFloor, legDestination, finalDestination, mass))
+        return;
+
+    StateGuard guard(*this);
+    CreateWaitingPassenger(currentFloor, legDestination, finalDestination, mass);
+}
+
+bool Elevator::IsValidPassenger(Floor currentFloor, Floor legDestination, Floor finalDestination, uint16 mass) const
+{
+    if (!Serves(currentFloor) || !Serves(legDestination) || !_geometry.IsValidFloor(finalDestination))
+    {
+        LOG_ERROR("elevator", "Incorrect floors for passenger: {} -> {} -> {}", currentFloor, legDestination, finalDestination);
+        return false;
+    }
+
+    // Passenger would wait forever
+    if (_capacity.Load && mass > _capacity.Load)
+    {
+        LOG_ERROR("elevator", "Passenger mass {} kg is over car capacity {} kg", mass, _capacity.Load);
+        return false;
+    }
+
+    return true;
+}
+
+void Elevator::CreateWaitingPassenger(Floor currentFloor, Floor legDestination, Floor finalDestination, uint16 mass)
+{
+    auto id = _passengers.Create(currentFloor, legDestination, _clock, mass);
+    if (finalDestination != legDestination)
+        _passengers.SetJourney(id, currentFloor, finalDestination, _clock);
+
+    AddWaiting(id);
+    BumpStateVersion();
+
+    if (_traceWriter)
+        _traceWriter->Record(_clock, currentFloor, finalDestination);
+
+    if (_demandModel)
+        _demandModel->AddArrival(_clock, currentFloor);
 }
 
-void Elevator::Update()
+void Elevator::ProcessIngress()
 {
+    _ingress.ConsumeAll([this](HallCall const& call)
+    {
+        if (IsValidPassenger(call.CurrentFloor, call.FloorNeed, call.FloorNeed, call.Mass))
+            CreateWaitingPassenger(call.CurrentFloor, call.FloorNeed, call.FloorNeed, call.Mass);
+    });
+}
+
+void Elevator::AddPassengerLeg(PassengerLeg const& leg)
+{
+    if (!Serves(leg.Origin) || !Serves(leg.Destination))
+    {
+        LOG_ERROR("elevator", "Incorrect floors for passenger transfer: {} -> {}", leg.Origin, leg.Destination);
+        return;
+    }
+
+    StateGuard guard(*this);
+
+    auto id = _passengers.Create(leg.Origin, leg.Destination, leg.ArrivalTime, leg.Mass);
+    _passengers.SetJourney(id, leg.JourneyOrigin, leg.FinalDestination, leg.JourneyStart);
+    AddWaiting(id);
+    BumpStateVersion();
+}
+
+std::size_t Elevator::TakeTransfers(std::vector<PassengerLeg>& transfers)
+{
+    std::lock_guard guard(_requestsLock);
+
+    auto count = _transfers.size();
+    transfers.insert(transfers.end(), _transfers.begin(), _transfers.end());
+    _transfers.clear();
+    return count;
+}
+
+void Elevator::AddRider(PassengerId id, uint8 deck)
+{
+    auto mass = _passengers.GetMass(id);
+
+    _riders.Add(_geometry.GetFloorIndex(_passengers.GetDestination(id)), id);
+    _passengers.SetDeck(id, deck);
+    _load += mass;
+    _deckRiders[deck]++;
+    _deckLoads[deck] += mass;
+}
+
+void Elevator::AddWaiting(PassengerId id)
+{
+    auto origin = _passengers.GetOrigin(id);
+    auto destination = _passengers.GetDestination(id);
+
+    GetWaiting(destination >= origin ? MovementType::Up : MovementType::Down).Add(_geometry.GetFloorIndex(origin), id);
+
+    auto destinationIndex = _geometry.GetFloorIndex(destination);
+    if (!_waitingDestinationCounts[destinationIndex]++)
+        _waitingDestinations.Set(destinationIndex);
+}
+
+uint32 Elevator::TransferHallCall(uint32 floorIndex, MovementType direction, Elevator& target)
+{
+    if (&target == this)
+        return 0;
+
+    std::scoped_lock guard(_requestsLock, target._requestsLock);
+
+    auto moveCount = GetWaiting(direction).TakeAll(floorIndex, [this, &target](PassengerId id)
+    {
+        auto destination = _passengers.GetDestination(id);
+        auto destinationIndex = _geometry.GetFloorIndex(destination);
+        if (!--_waitingDestinationCounts[destinationIndex])
+            _waitingDestinations.Reset(destinationIndex);
+
+        auto targetId = target._passengers.Create(_passengers.GetOrigin(id), destination, _passengers.GetArrivalTime(id), _passengers.GetMass(id));
+        target._passengers.SetJourney(targetId, _passengers.GetJourneyOrigin(id), _passengers.GetFinalDestination(id), _passengers.GetJourneyStart(id));
+        target.AddWaiting(targetId);
+        _passengers.Release(id);
+    });
+
+    if (moveCount)
+    {
+        BumpStateVersion();
+        target.BumpStateVersion();
+        PublishSnapshot();
+        target.PublishSnapshot();
+    }
+
+    return moveCount;
+}
+
+std::size_t Elevator::GetRidingCount()
+{
+    std::lock_guard guard(_requestsLock);
+    return _riders.GetCount();
+}
+
+std::size_t Elevator::GetWaitingCount()
+{
+    std::lock_guard guard(_requestsLock);
+    return _waitingUp.GetCount() + _waitingDown.GetCount();
+}
+
+void Elevator::Update(Milliseconds diff)
+{
+    StateGuard guard(*this);
+
+    _clock += diff;
+
+    // Posted hall calls of all producers in one batch
+    ProcessIngress();
+
+    // Car flies between floors or cycles doors. Nothing else to do in this tick
+    if (_clock < _busyUntil)
+        return;
+
+    // Flight ended on target floor
+    if (_isTravelling)
+    {
+        _isTravelling = false;
+        MoveToFloor(_targetFloor);
+    }
+
     // Pop passengers from elevator
-    ProcessExitPassengers();
+    auto stopCount = ProcessExitPassengers();
 
     // Emplace passenger in elevator
-    ProcessPopulatePassengers();
+    stopCount += ProcessPopulatePassengers();
+
+    // Doors opened for passengers. Next floor is selected after doors close
+    if (_flightTimes && stopCount)
+    {
+        _busyUntil = _clock + _flightTimes->GetStopTime();
+        return;
+    }
 
     // if all queues empty - no passenger. Skip next steps and stop elevator
-    if (_elevatorQueue.Empty() && _floorQueue.Empty())
+    if (!HasRequests())
     {
+        // Idle car keeps its decision until demand changes
+        if (!SelectParkingFloor())
+            return;
+
+        // Wait next passenger where he most likely comes from
+        if (_parkingFloor != _currentFloor)
+        {
+            LOG_INFO("elevator", "Not found any passengers. Park elevator in floor: {}", _parkingFloor);
+
+            // Car stays idle after arrival, parking floor is checked there again
+            _isParkingSelected = false;
+            StartTravel(_parkingFloor);
+            return;
+        }
+
         LOG_WARN("elevator", "Not found any passengers. Stay elevator in floor: {}", _currentFloor);
         LOG_INFO("elevator", "");
 
@@ -77,140 +360,463 @@ void Elevator::Update()
         return;
     }
 
+    _isParkingSelected = false;
+
     LOG_INFO("elevator", "Elevator info: Movement: {}. Current floor: {}", _movementType == MovementType::Up ? "Up" : "Down", _currentFloor);
     LOG_INFO("elevator", "");
 
-    // Try to get next floor for elevator
-    auto nextFloor = GetNextFloor();
+    // Try to get next floor for elevator and move
+    StartTravel(FindNextFloor());
+}
+
+void Elevator::SetCapacity(CarCapacity const& capacity)
+{
+    StateGuard guard(*this);
+
+    _capacity = capacity;
+    UpdateFull();
+    BumpStateVersion();
+}
+
+void Elevator::SetDoubleDeck(bool isDoubleDeck)
+{
+    StateGuard guard(*this);
+
+    _deckCount = isDoubleDeck ? MAX_DECK_COUNT : 1;
+    _currentFloor = GetStopFloor(_currentFloor);
+    UpdateFull();
+    BumpStateVersion();
+}
+
+bool Elevator::HasDeckRoom(uint8 deck, uint32 mass) const
+{
+    if (_capacity.Persons && _deckRiders[deck] >= _capacity.Persons)
+        return false;
+
+    return !_capacity.Load || _deckLoads[deck] + mass <= _capacity.Load;
+}
+
+uint8 Elevator::SelectDeck(PassengerId id) const
+{
+    auto mass = _passengers.GetMass(id);
+    auto origin = _passengers.GetOrigin(id);
+
+    // Passenger on other floors reaches only deck stopped on his floor. Who rides to floor of other deck walks one floor
+    if (_deckCount == 1 || origin != _geometry.LobbyFloor)
+    {
+        auto deck = GetDeck(origin);
+        return HasDeckRoom(deck, mass) ? deck : DECK_NONE;
+    }
+
+    // Lobby has escalator between decks. Passenger takes deck of his destination, other deck if it is full
+    auto deck = GetDeck(_passengers.GetDestination(id));
+    if (HasDeckRoom(deck, mass))
+        return deck;
+
+    deck ^= 1;
+    return HasDeckRoom(deck, mass) ? deck : DECK_NONE;
+}
+
+void Elevator::UpdateFull()
+{
+    bool hasRoom{};
+    for (uint8 deck{}; deck < _deckCount; deck++)
+        hasRoom = hasRoom || HasDeckRoom(deck, DEFAULT_PASSENGER_MASS);
+
+    _isFull = _isLeftBehind || !hasRoom;
+}
+
+void Elevator::ProcessStop()
+{
+    StateGuard guard(*this);
+
+    ProcessExitPassengers();
+    ProcessPopulatePassengers();
+}
+
+bool Elevator::HasPassengers()
+{
+    std::lock_guard guard(_requestsLock);
+    return HasRequests();
+}
+
+bool Elevator::IsIdle()
+{
+    std::lock_guard guard(_requestsLock);
+    return !HasRequests() && !_isTravelling && _clock >= _busyUntil;
+}
+
+bool Elevator::Park(Floor floor)
+{
+    if (!Serves(floor))
+        return false;
+
+    StateGuard guard(*this);
+
+    // Passenger came while parking floor was selected
+    if (HasRequests() || _isTravelling || _clock < _busyUntil)
+        return false;
+
+    LOG_INFO("elevator", "Not found any passengers. Park elevator in floor: {}", floor);
+    StartTravel(floor);
+    return true;
+}
+
+void Elevator::MoveTo(Floor floor)
+{
+    if (!_geometry.IsValidFloor(floor))
+    {
+        LOG_ERROR("elevator", "Incorrect floor for elevator move: {}", floor);
+        return;
+    }
+
+    StateGuard guard(*this);
+    MoveToFloor(floor);
+}
+
+void Elevator::SetClock(Milliseconds clock)
+{
+    std::lock_guard guard(_requestsLock);
+    _clock = clock;
+}
+
+void Elevator::MoveToFloor(Floor floor)
+{
+    floor = GetStopFloor(floor);
 
+    UpdateMovementType(floor);
+
+    // Set new current floor
+    _currentFloor = floor;
+    BumpStateVersion();
+}
+
+void Elevator::UpdateMovementType(Floor floor)
+{
     // Change movement type if need
-    if (_movementType == MovementType::Up && nextFloor < _currentFloor)
+    if (_movementType == MovementType::Up && floor < _currentFloor)
         _movementType = MovementType::Down;
-    else if (_movementType == MovementType::Down && nextFloor > _currentFloor)
+    else if (_movementType == MovementType::Down && floor > _currentFloor)
         _movementType = MovementType::Up;
-
-    // Set new current floor
-    _currentFloor = nextFloor;
 }
 
-void Elevator::ProcessExitPassengers()
+void Elevator::StartTravel(Floor floor)
 {
-    if (_elevatorQueue.Empty())
+    floor = GetStopFloor(floor);
+
+    if (!_flightTimes || floor == _currentFloor)
+    {
+        MoveToFloor(floor);
         return;
+    }
 
-    std::vector<ElevatorPassenger*> requeue;
-    ElevatorPassenger* passenger{ nullptr };
-    std::size_t exitCount{};
+    // Direction is known at departure, floor changes at arrival
+    UpdateMovementType(floor);
 
-    while (_elevatorQueue.GetNext(passenger))
-    {
-        // Check current floor and remove passenger if need
-        if (passenger->FloorNeed == _currentFloor)
-        {
-            LOG_DEBUG("elevator", "Passenger exit in floor: {}", _currentFloor);
-            delete passenger;
-            exitCount++;
-            continue;
-        }
+    _energy += _flightTimes->GetEnergy(_currentFloor, floor, _load);
+    _targetFloor = floor;
+    _isTravelling = true;
+    _busyUntil = _clock + _flightTimes->GetFlightTime(_currentFloor, floor);
+    BumpStateVersion();
+}
+
+bool Elevator::SelectParkingFloor()
+{
+    uint32 bucket{};
+    uint64 arrivalCount{};
 
-        requeue.emplace_back(passenger);
+    if (_demandModel)
+    {
+        bucket = _demandModel->GetBucket(_clock);
+        arrivalCount = _demandModel->GetArrivalCount();
     }
 
-    // Re add passengers in queue if need
-    if (!requeue.empty())
-        _elevatorQueue.ReadContainer(requeue);
+    if (_isParkingSelected && bucket == _parkingBucket && arrivalCount == _parkingArrivalCount)
+        return false;
+
+    _isParkingSelected = true;
+    _parkingBucket = bucket;
+    _parkingArrivalCount = arrivalCount;
 
-    if (exitCount)
-        LOG_DEBUG("elevator", "Exit count: {}", exitCount);
+    // Parking query is O(floors^2), so it runs only when car becomes idle or demand changes
+    _parkingFloor = _demandModel ? _demandModel->GetParkingFloor(_clock, _currentFloor, {}, &_servedFloors) : _currentFloor;
+    return true;
 }
 
-void Elevator::ProcessPopulatePassengers()
+uint32 Elevator::ProcessExitPassengers()
 {
-    if (_floorQueue.Empty())
-        return;
+    auto floorIndex = _geometry.GetFloorIndex(_currentFloor);
+    uint32 exitCount{};
 
-    std::vector<FloorPassenger*> requeue;
-    FloorPassenger* passenger{ nullptr };
-    std::size_t enterCount{};
+    // Both decks of double-deck car open on stop. Upper deck is on floor above stop
+    for (uint32 deck{}; deck < _deckCount && floorIndex + deck < _geometry.GetFloorCount(); deck++)
+        exitCount += ExitPassengers(floorIndex + deck);
+
+    return exitCount;
+}
 
-    while (_floorQueue.GetNext(passenger))
+uint32 Elevator::ExitPassengers(uint32 floorIndex)
+{
+    if (!_riders.GetCount(floorIndex))
+        return 0;
+
+    auto floor = _geometry.GetFloorByIndex(floorIndex);
+    std::size_t transferCount{};
+
+    auto exitCount = _riders.TakeAll(floorIndex, [this, floor, &transferCount](PassengerId id)
     {
-        // Check current floor and remove passenger if need
-        if (passenger->CurrentFloor == _currentFloor)
+        LOG_DEBUG("elevator", "Passenger exit in floor: {}", floor);
+
+        auto ride = _clock - _passengers.GetBoardTime(id);
+        auto finalDestination = _passengers.GetFinalDestination(id);
+
+        // Transfer floor. Passenger waits next car, journey continues
+        if (finalDestination != floor)
         {
-            LOG_DEBUG("elevator", "Add new elevator passenger. Floor need: {}", passenger->FloorNeed);
+            auto originIndex = _geometry.GetFloorIndex(_passengers.GetOrigin(id));
+            _stats.AddRide(originIndex, ride);
 
-            AddPassengerToElevator(passenger->FloorNeed);
-            enterCount++;
-            delete passenger;
-            continue;
+            _transfers.push_back({ floor, finalDestination, _passengers.GetJourneyOrigin(id), finalDestination, _passengers.GetJourneyStart(id), _clock, _passengers.GetMass(id) });
+            transferCount++;
+        }
+        else
+        {
+            auto originIndex = _geometry.GetFloorIndex(_passengers.GetJourneyOrigin(id));
+            auto journey = _clock - _passengers.GetJourneyStart(id);
+            _stats.AddTrip(originIndex, ride, journey);
         }
 
-        requeue.emplace_back(passenger);
+        auto mass = _passengers.GetMass(id);
+        auto deck = _passengers.GetDeck(id);
+        _load -= mass;
+        _deckRiders[deck]--;
+        _deckLoads[deck] -= mass;
+        _passengers.Release(id);
+    });
+
+    _deliveredCount += exitCount - transferCount;
+    _isLeftBehind = false;
+    UpdateFull();
+    BumpStateVersion();
+    LOG_DEBUG("elevator", "Exit count: {}", exitCount);
+    return exitCount;
+}
+
+uint32 Elevator::ProcessPopulatePassengers()
+{
+    auto floorIndex = _geometry.GetFloorIndex(_currentFloor);
+    auto stopFloorCount = std::min<uint32>(_deckCount, _geometry.GetFloorCount() - floorIndex);
+
+    bool hasWaiting{};
+    for (uint32 i{}; i < stopFloorCount; i++)
+        hasWaiting = hasWaiting || _waitingUp.GetCount(floorIndex + i) || _waitingDown.GetCount(floorIndex + i);
+
+    if (!hasWaiting)
+        return 0;
+
+    uint32 enterCount{};
+    _isLeftBehind = false;
+
+    for (uint32 i{}; i < stopFloorCount; i++)
+    {
+        enterCount += BoardPassengers(floorIndex + i);
+        _isLeftBehind = _isLeftBehind || _waitingUp.GetCount(floorIndex + i) || _waitingDown.GetCount(floorIndex + i);
     }
 
-    // Re add passengers in queue if need
-    if (!requeue.empty())
-        _floorQueue.ReadContainer(requeue);
+    UpdateFull();
+    BumpStateVersion();
+    return enterCount;
+}
+
+uint32 Elevator::BoardPassengers(uint32 floorIndex)
+{
+    if (!_waitingUp.GetCount(floorIndex) && !_waitingDown.GetCount(floorIndex))
+        return 0;
+
+    // Deck is selected by fit check and used by board in same pass
+    uint8 deck{};
+
+    auto boardPassenger = [this, floorIndex, &deck](PassengerId id)
+    {
+        LOG_DEBUG("elevator", "Add new elevator passenger. Floor need: {}", _passengers.GetDestination(id));
+
+        auto wait = _clock - _passengers.GetArrivalTime(id);
+        _stats.AddWait(floorIndex, wait);
+
+        auto destinationIndex = _geometry.GetFloorIndex(_passengers.GetDestination(id));
+        if (!--_waitingDestinationCounts[destinationIndex])
+            _waitingDestinations.Reset(destinationIndex);
+
+        _passengers.SetBoardTime(id, _clock);
+        AddRider(id, deck);
+    };
+
+    auto canBoard = [this, &deck](PassengerId id)
+    {
+        deck = SelectDeck(id);
+        return deck != DECK_NONE;
+    };
+
+    // Passengers going in car direction enter first. Who doesn't fit waits next car in queue order
+    auto& forward = GetWaiting(_movementType);
+    auto& backward = GetWaiting(_movementType == MovementType::Up ? MovementType::Down : MovementType::Up);
+
+    auto enterCount = forward.TakeWhile(floorIndex, canBoard, boardPassenger);
+    enterCount += backward.TakeWhile(floorIndex, canBoard, boardPassenger);
 
-    if (enterCount)
-        LOG_DEBUG("elevator", "Enter count: {}", enterCount);
+    LOG_DEBUG("elevator", "Enter count: {}", enterCount);
+    return enterCount;
 }
 
-uint8 Elevator::GetNextFloor()
+Floor Elevator::GetNextFloor()
 {
-    uint8 nextFloorUp{ FLOOR_COUNT_MAX };
-    uint8 nextFloorDown{ FLOOR_COUNT_MIN };
+    std::lock_guard guard(_requestsLock);
+    return FindNextFloor();
+}
+
+Floor Elevator::FindNextFloor() const
+{
+    return GetStopFloor(std::visit([this](auto const& policy) { return policy.SelectNextFloor(GetDispatchState()); }, _dispatchPolicy));
+}
+
+bool Elevator::HasStopAt(Floor floor)
+{
+    if (!_geometry.IsValidFloor(floor))
+        return false;
+
+    return GetSnapshot()->HasStopAt(_geometry.GetFloorIndex(floor));
+}
+
+void Elevator::UpdateEtaTable(EtaTable& table, EtaTiming const& timing)
+{
+    // Snapshot has all counts of table, so slow car update never delays dispatcher
+    auto snapshot = GetSnapshot();
+    if (!table.IsValid(snapshot->Version))
+        table.Build(*snapshot, _geometry, timing);
+}
+
+std::optional<uint32> Elevator::GetDestinationStopDistance(Floor floor)
+{
+    if (!_geometry.IsValidFloor(floor))
+        return {};
+
+    return GetSnapshot()->GetDestinationStopDistance(_geometry.GetFloorIndex(floor));
+}
+
+void Elevator::SetCurrentFloor(Floor floor, MovementType movementType)
+{
+    StateGuard guard(*this);
+    _currentFloor = floor;
+    _movementType = movementType;
+    BumpStateVersion();
+}
+
+void Elevator::PublishSnapshot()
+{
+    auto version = _stateVersion.load(std::memory_order_relaxed);
+    if (version == _publishedVersion)
+        return;
+
+    // Buffer released by all readers is refilled without allocation. Fence pairs with release of last reader reference
+    if (_spareSnapshot && _spareSnapshot.use_count() == 1)
+        std::atomic_thread_fence(std::memory_order_acquire);
+    else
+        _spareSnapshot = std::make_shared<ElevatorSnapshot>();
+
+    FillSnapshot(*_spareSnapshot);
+
+    // Previous snapshot becomes spare for next publish
+    std::shared_ptr<ElevatorSnapshot const> published = std::move(_spareSnapshot);
+    _spareSnapshot = std::const_pointer_cast<ElevatorSnapshot>(_snapshot.exchange(std::move(published), std::memory_order_acq_rel));
+    _publishedVersion = version;
+}
 
-    for (auto passenger : _elevatorQueue)
+void Elevator::FillSnapshot(ElevatorSnapshot& snapshot) const
+{
+    auto floorCount = _geometry.GetFloorCount();
+
+    snapshot.Version = _stateVersion.load(std::memory_order_relaxed);
+    snapshot.CurrentFloor = _currentFloor;
+    snapshot.Movement = _movementType;
+    snapshot.IsTravelling = _isTravelling;
+    snapshot.IsFull = _isFull;
+    snapshot.DeckCount = _deckCount;
+    snapshot.Load = _load;
+    snapshot.RidingCount = static_cast<uint32>(_riders.GetCount());
+    snapshot.WaitingCount = static_cast<uint32>(_waitingUp.GetCount() + _waitingDown.GetCount());
+    snapshot.DeliveredCount = _deliveredCount;
+
+    snapshot.Riders.resize(floorCount);
+    snapshot.WaitingUp.resize(floorCount);
+    snapshot.WaitingDown.resize(floorCount);
+
+    for (uint32 i{}; i < floorCount; i++)
     {
-        if (nextFloorUp > passenger->FloorNeed && _currentFloor < passenger->FloorNeed)
-            nextFloorUp = passenger->FloorNeed;
-        else if (nextFloorDown < passenger->FloorNeed && _currentFloor > passenger->FloorNeed)
-            nextFloorDown = passenger->FloorNeed;
+        snapshot.Riders[i] = _riders.GetCount(i);
+        snapshot.WaitingUp[i] = _waitingUp.GetCount(i);
+        snapshot.WaitingDown[i] = _waitingDown.GetCount(i);
     }
 
-    for (auto passenger : _floorQueue)
+    auto fillDestinations = [this](PassengerBuckets const& waiting, std::vector<uint32>& destinations)
     {
-        if (nextFloorUp > passenger->CurrentFloor && _currentFloor < passenger->CurrentFloor)
-            nextFloorUp = passenger->CurrentFloor;
-        else if (nextFloorDown < passenger->CurrentFloor && _currentFloor > passenger->CurrentFloor)
-            nextFloorDown = passenger->CurrentFloor;
-    }
+        // Reused snapshot buffer doesn't grow after passenger storage is reserved
+        destinations.clear();
+        destinations.reserve(_passengers.GetCapacity());
 
-    // Check max floor
-    if (_movementType == MovementType::Up && _currentFloor == FLOOR_COUNT_MAX)
-        return nextFloorDown;
+        auto const& callFloors = waiting.GetFloors();
+        for (auto floorIndex = FloorSet::FindNext(0, callFloors); floorIndex != FloorSet::npos; floorIndex = FloorSet::FindNext(floorIndex + 1, callFloors))
+            waiting.ForEach(floorIndex, [&](PassengerId id) { destinations.push_back(_geometry.GetFloorIndex(_passengers.GetDestination(id))); });
+    };
 
-    // Check min floor
-    if (_movementType == MovementType::Down && _currentFloor == FLOOR_COUNT_MIN)
-        return nextFloorUp;
+    fillDestinations(_waitingUp, snapshot.WaitingUpDestinations);
+    fillDestinations(_waitingDown, snapshot.WaitingDownDestinations);
 
-    if (_movementType == MovementType::Up && nextFloorUp > _currentFloor)
-        return nextFloorUp;
+    snapshot.RiderFloors = _riders.GetFloors();
+    snapshot.WaitingDestinations = _waitingDestinations;
+}
 
-    return nextFloorDown;
+void Elevator::ResizeFloorRequests()
+{
+    auto floorCount = _geometry.GetFloorCount();
+
+    _riders.Resize(floorCount);
+    _waitingUp.Resize(floorCount);
+    _waitingDown.Resize(floorCount);
+    _waitingDestinationCounts.assign(floorCount, 0);
+    _waitingDestinations.Resize(floorCount);
+    _servedFloors.Resize(floorCount);
+    _stats.Resize(floorCount);
+
+    for (uint32 i{}; i < floorCount; i++)
+        _servedFloors.Set(i);
 }
 
-uint8 Elevator::GetRandomNumber()
+Floor Elevator::GetRandomFloor()
 {
-    // Random engine
-    static std::random_device rd;
-    static std::mt19937 generator(rd());
+    auto floorIndex = static_cast<uint32>(_generator.NextBelow(_geometry.GetFloorCount()));
+
+    // Next served floor above random one, or lowest served floor
+    if (!_servedFloors.Test(floorIndex))
+    {
+        floorIndex = FloorSet::FindNext(floorIndex, _servedFloors);
+        if (floorIndex == FloorSet::npos)
+            floorIndex = FloorSet::FindNext(0, _servedFloors);
 
-    std::uniform_int_distribution<> distribution(1, 9);
+        if (floorIndex == FloorSet::npos)
+            return _currentFloor;
+    }
 
-    return distribution(generator);
+    return _geometry.GetFloorByIndex(floorIndex);
 }
 
 void Elevator::AddRandomPassengers(uint8 count /*= 5*/)
 {
     for (uint8 i{}; i < count; i++)
-        AddPassenger(GetRandomNumber(), GetRandomNumber());
+        AddPassenger(GetRandomFloor(), GetRandomFloor());
 }
 
 void Elevator::AddRandomElevatorPassengers(uint8 count /*= 5*/)
 {
     for (uint8 i{}; i < count; i++)
-        AddPassengerToElevator(GetRandomNumber());
+        AddPassengerToElevator(GetRandomFloor());
 }
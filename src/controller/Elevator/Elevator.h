@@ -18,118 +18,465 @@
 #ifndef WARHEAD_ELEVATOR_H_
 #define WARHEAD_ELEVATOR_H_
 
-#include "Define.h"
-#include "LockedQueue.h"
+#include "Building.h"
+#include "DispatchPolicyRegistry.h"
+#include "ElevatorSnapshot.h"
+#include "EtaTable.h"
+#include "MPSCQueue.h"
+#include "PassengerBuckets.h"
+#include "PassengerStats.h"
+#include "Random.h"
+#include <array>
 #include <atomic>
-#include <functional>
-
-// Exit code for main function
-enum ShutdownExitCode : uint8
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <span>
+#include <vector>
+
+class DemandModel;
+class FlightTimeTable;
+class PassengerTraceWriter;
+
+// Hall call of passenger on floor
+struct FloorPassenger
 {
-    SHUTDOWN_EXIT_CODE,
-    ERROR_EXIT_CODE
-};
+    explicit FloorPassenger(Floor currentFloor, Floor floorNeed) :
+        CurrentFloor(currentFloor), FloorNeed(floorNeed) { }
 
-// Elevator command
-enum class MovementType : uint8
-{
-    Up,
-    Down
+    Floor CurrentFloor{};
+    Floor FloorNeed{};
 };
 
-// Object for passengers in elevator
-struct ElevatorPassenger
+// Hall call posted by producer thread. Validated and timestamped by update thread
+struct HallCall
 {
-    explicit ElevatorPassenger(uint8 floorNeed) :
-        FloorNeed(floorNeed) { }
-
-    uint8 FloorNeed{};
+    Floor CurrentFloor{};
+    Floor FloorNeed{};
+    uint16 Mass{ DEFAULT_PASSENGER_MASS };
 };
 
-// Object for passengers on floors
-struct FloorPassenger
+// Next car leg of passenger journey with transfers
+struct PassengerLeg
 {
-    explicit FloorPassenger(uint8 currentFloor, uint8 floorNeed) :
-        CurrentFloor(currentFloor), FloorNeed(floorNeed) { }
-
-    uint8 CurrentFloor{};
-    uint8 FloorNeed{};
+    Floor Origin{};
+    Floor Destination{};
+    Floor JourneyOrigin{};
+    Floor FinalDestination{};
+    Milliseconds JourneyStart{};
+
+    // Time of leaving previous car. Wait of next leg starts here
+    Milliseconds ArrivalTime{};
+    uint16 Mass{ DEFAULT_PASSENGER_MASS };
 };
 
 class WH_CTRL_API Elevator
 {
 public:
-    Elevator() = default;
+    explicit Elevator(BuildingGeometry const& geometry = {});
     ~Elevator() = default;
 
-    // Singleton
-    static Elevator* instance();
-
     // Default start. Add random passengers on floors
     void Start();
 
     // Reset all queues
     void ResetAllPassengers();
 
-    // Add passenger in _elevatorQueue
-    void AddPassengerToElevator(uint8 floorNeed);
+    // Reserve storage for count passengers. Update does no allocations while passengers fit in storage
+    void ReservePassengers(std::size_t count);
+
+    // Change floors served by elevator. Reset all queues and move elevator to lobby
+    void SetGeometry(BuildingGeometry const& geometry);
+
+    // Limit floors where car stops. Empty - all floors. Move car to lowest served floor if current floor is not served.
+    // Invalid floors are skipped. List without valid floors is rejected and served floors don't change
+    void SetServedFloors(std::span<Floor const> floors);
+
+    // Check if car stops at floor. O(1) bitset lookup
+    [[nodiscard]] inline bool Serves(Floor floor) const { return _geometry.IsValidFloor(floor) && _servedFloors.Test(_geometry.GetFloorIndex(floor)); }
+
+    // Get floors where car stops by floor index
+    [[nodiscard]] inline FloorSet const& GetServedFloors() const { return _servedFloors; }
+
+    // Seed random generator of this elevator
+    void SetRandomSeed(uint64 seed);
+
+    // Record all new passengers in trace. nullptr - stop recording
+    inline void SetTraceWriter(PassengerTraceWriter* writer) { _traceWriter = writer; }
+
+    // Learn hall calls of this elevator in demand model and park idle elevator by it. nullptr - stay on floor when idle
+    inline void SetDemandModel(DemandModel* demandModel) { _demandModel = demandModel; }
+
+    // Add passenger in elevator on current floor
+    void AddPassengerToElevator(Floor floorNeed);
+
+    // Add passenger waiting elevator on floor
+    void AddPassenger(Floor currentFloor, Floor floorNeed, uint16 mass = DEFAULT_PASSENGER_MASS);
+
+    // Add passenger waiting elevator on floor from any thread without lock. Passenger is added by next Update in one batch
+    // with arrival time of that update. Falls back to AddPassenger if ingress queue is full
+    void PostPassenger(Floor currentFloor, Floor floorNeed, uint16 mass = DEFAULT_PASSENGER_MASS);
+
+    // Check if posted passengers wait next Update. Not while Update runs on other thread
+    [[nodiscard]] inline bool HasPostedPassengers() const { return !_ingress.Empty(); }
+
+    // Add passenger waiting elevator on floor whose journey continues from leg destination to final destination in other car
+    void AddJourneyPassenger(Floor currentFloor, Floor legDestination, Floor finalDestination, uint16 mass = DEFAULT_PASSENGER_MASS);
+
+    // Add passenger changing car on transfer floor. Passenger keeps journey start and final destination
+    void AddPassengerLeg(PassengerLeg const& leg);
+
+    // Move passengers who left car on transfer floor since last call in transfers. Returns count of moved passengers
+    std::size_t TakeTransfers(std::vector<PassengerLeg>& transfers);
+
+    // Move passengers waiting on floor in direction to other car. Passengers keep arrival time. Returns count of moved passengers
+    uint32 TransferHallCall(uint32 floorIndex, MovementType direction, Elevator& target);
+
+    // Update elevator. Advance clock, change current floor, movement, execute all queues
+    void Update(Milliseconds diff);
+
+    // Fly between floors and cycle doors by building flight times in Update. nullptr - car moves to next floor in one update
+    inline void SetFlightTimes(FlightTimeTable const* flightTimes) { _flightTimes = flightTimes; }
+
+    // Check if car flies to next floor. Current floor is floor of departure until arrival
+    [[nodiscard]] inline bool IsTravelling() const { return _isTravelling; }
+
+    // Get drive energy of all trips, J. Counted only with flight times
+    [[nodiscard]] inline double GetEnergy() const { return _energy; }
 
-    // Add passenger in _floorQueue
-    void AddPassenger(uint8 currentFloor, uint8 floorNeed);
+    // Change rated load of car. Passengers already in car stay
+    void SetCapacity(CarCapacity const& capacity);
 
-    // Update elevator. Change current floor, movement, execute all queues
-    void Update();
+    // Get rated load of car
+    [[nodiscard]] inline CarCapacity const& GetCapacity() const { return _capacity; }
 
-    // Get cancel token
-    [[nodiscard]] static bool IsStopped() { return _cancel; }
+    // Get mass of passengers in car, kg
+    [[nodiscard]] inline uint32 GetLoad() const { return _load; }
 
-    // Get exit code for main function
-    static uint8 GetExitCode() { return _exitCode; }
+    // Couple second deck above car. Double-deck car stops on floor pairs: lower deck on floor of stop, upper deck on floor above.
+    // Capacity is per deck. Car on upper floor of pair moves to lower one
+    void SetDoubleDeck(bool isDoubleDeck);
 
-    // Stop all works and set new exit code
-    static void StopNow(uint8 exitcode) { _cancel = true; _exitCode = exitcode; }
+    [[nodiscard]] inline bool IsDoubleDeck() const { return _deckCount == MAX_DECK_COUNT; }
 
-    // Get next floor for elevator
-    uint8 GetNextFloor();
+    // Get mass of passengers in deck, kg. 0 - lower deck
+    [[nodiscard]] inline uint32 GetDeckLoad(uint8 deck) const { return _deckLoads[deck]; }
+
+    // Get floor where car stops to serve floor. Lower floor of pair for double-deck car
+    [[nodiscard]] inline Floor GetStopFloor(Floor floor) const { return static_cast<Floor>(floor - GetDeck(floor)); }
+
+    // Check if car can't take more passengers. Full car bypasses hall calls. O(1) flag, updated on every load change
+    [[nodiscard]] inline bool IsFull() const { return _isFull; }
+
+    // Exit and board passengers on current floor. Used by event driven simulation
+    void ProcessStop();
+
+    // Check if any passenger is in elevator or waiting it
+    bool HasPassengers();
+
+    // Check if car has no passengers, stands and doors are closed
+    bool IsIdle();
+
+    // Start travel of idle car to parking floor. Returns false if car isn't idle any more or doesn't serve floor
+    bool Park(Floor floor);
+
+    // Move elevator to floor. Change movement type if need
+    void MoveTo(Floor floor);
+
+    // Set elevator clock. Used by event driven simulation
+    void SetClock(Milliseconds clock);
+
+    // Get next floor for elevator selected by dispatch policy of elevator
+    Floor GetNextFloor();
+
+    // Get next floor selected by policy. Decision is inlined, use in hot loops
+    template<DispatchPolicy Policy>
+    Floor GetNextFloor(Policy const& policy)
+    {
+        std::lock_guard guard(_requestsLock);
+        return GetStopFloor(policy.SelectNextFloor(GetDispatchState()));
+    }
+
+    // Call fn(DispatchState const&) with locked car state
+    template<class Fn>
+    decltype(auto) ReadDispatchState(Fn&& fn)
+    {
+        std::lock_guard guard(_requestsLock);
+        return fn(GetDispatchState());
+    }
+
+    // Change policy selecting next floor
+    inline void SetDispatchPolicy(AnyDispatchPolicy const& policy) { _dispatchPolicy = policy; }
+
+    // Get policy selecting next floor
+    [[nodiscard]] inline AnyDispatchPolicy const& GetDispatchPolicy() const { return _dispatchPolicy; }
 
     // Set current floor and movement type for elevator
-    inline void SetCurrentFloor(uint8 floor, MovementType movementType) { _currentFloor = floor; _movementType = movementType; }
+    void SetCurrentFloor(Floor floor, MovementType movementType);
+
+    // Get current floor for elevator
+    [[nodiscard]] inline Floor GetCurrentFloor() const { return _currentFloor; }
+
+    // Get current movement type for elevator
+    [[nodiscard]] inline MovementType GetMovementType() const { return _movementType; }
+
+    // Get count of passengers in elevator
+    [[nodiscard]] std::size_t GetRidingCount();
+
+    // Get count of passengers waiting this elevator on floors
+    [[nodiscard]] std::size_t GetWaitingCount();
+
+    // Get elevator clock. Sum of all update diffs
+    [[nodiscard]] inline Milliseconds GetClock() const { return _clock; }
+
+    // Get floors served by elevator
+    [[nodiscard]] inline BuildingGeometry const& GetGeometry() const { return _geometry; }
+
+    // Get count of passengers delivered to their floor
+    [[nodiscard]] inline std::size_t GetDeliveredCount() const { return _deliveredCount; }
+
+    // Get wait, ride and journey time histograms of passengers. Written only by car update
+    [[nodiscard]] inline PassengerStats const& GetStats() const { return _stats; }
+
+    // Check if elevator will stop at floor for any passenger. Reads snapshot of car
+    bool HasStopAt(Floor floor);
+
+    // Version of car floor, movement and stops. Changed on every change of them
+    [[nodiscard]] inline uint64 GetStateVersion() const { return _stateVersion.load(std::memory_order_acquire); }
+
+    // Rebuild ETA table from published snapshot if it was built for other state version. Never locks car
+    void UpdateEtaTable(EtaTable& table, EtaTiming const& timing);
+
+    // Get distance in floors to nearest destination of passengers in car or waiting it. 0 - car will stop at floor for passenger destination. Empty - no destinations
+    std::optional<uint32> GetDestinationStopDistance(Floor floor);
+
+    // Get immutable car state published by last change of car. Never locks car. Holder keeps reading it while car moves on
+    [[nodiscard]] inline std::shared_ptr<ElevatorSnapshot const> GetSnapshot() const { return _snapshot.load(std::memory_order_acquire); }
 
 private:
-    // Add random count passengers in _elevatorQueue
+    // Hall calls posted between two updates before producers fall back to lock
+    static constexpr std::size_t INGRESS_CAPACITY = 1024;
+
+    // Decks of double-deck car
+    static constexpr uint8 MAX_DECK_COUNT = 2;
+
+    // Returned by deck selection if passenger fits in no deck
+    static constexpr uint8 DECK_NONE = MAX_DECK_COUNT;
+
+    // Add random count passengers waiting on floors
     void AddRandomPassengers(uint8 count = 5);
 
-    // Add random count passengers in _floorQueue
+    // Add random count passengers in elevator
     void AddRandomElevatorPassengers(uint8 count = 5);
 
-    // Pop passengers from elevator (execute _elevatorQueue)
-    void ProcessExitPassengers();
+    // Pop passengers from elevator on current floor (execute _riders). Returns count of passengers exited
+    uint32 ProcessExitPassengers();
 
-    // Emplace passenger in elevator (execute _floorQueue)
-    void ProcessPopulatePassengers();
+    // Emplace passengers from current floor in elevator (execute _waitingUp and _waitingDown). Returns count of passengers entered
+    uint32 ProcessPopulatePassengers();
 
-    // Get random number between 1 and 9 (min and max floors)
-    static uint8 GetRandomNumber();
+    // Pop passengers with destination floor from elevator. Returns count of passengers exited. Requires _requestsLock
+    uint32 ExitPassengers(uint32 floorIndex);
+
+    // Emplace passengers waiting on floor in elevator. Returns count of passengers entered. Requires _requestsLock
+    uint32 BoardPassengers(uint32 floorIndex);
+
+    // Add passenger in _riders on his destination floor and in load of deck. Requires _requestsLock
+    void AddRider(PassengerId id, uint8 deck);
+
+    // Add passenger in waiting bucket of his floor and direction. Requires _requestsLock
+    void AddWaiting(PassengerId id);
+
+    // Check floors and mass of new passenger. Logs error for invalid passenger
+    bool IsValidPassenger(Floor currentFloor, Floor legDestination, Floor finalDestination, uint16 mass) const;
+
+    // Create valid passenger waiting on floor, record it in trace and demand model. Requires _requestsLock
+    void CreateWaitingPassenger(Floor currentFloor, Floor legDestination, Floor finalDestination, uint16 mass);
+
+    // Add all posted hall calls. Requires _requestsLock
+    void ProcessIngress();
+
+    // Get next floor selected by dispatch policy of elevator. Requires _requestsLock
+    Floor FindNextFloor() const;
+
+    // Get car state for dispatch policy. Requires _requestsLock
+    [[nodiscard]] inline DispatchState GetDispatchState() const
+    {
+        return { _geometry, _currentFloor, _movementType, _passengers, _riders, _waitingUp, _waitingDown, _isFull };
+    }
+
+    // Set current floor and movement to floor. Requires _requestsLock
+    void MoveToFloor(Floor floor);
+
+    // Turn movement to floor if need. Requires _requestsLock
+    void UpdateMovementType(Floor floor);
+
+    // Start flight to floor by flight times or move to it at once without them. Requires _requestsLock
+    void StartTravel(Floor floor);
+
+    // Select parking floor of idle car. Returns false if selection didn't change since car became idle. Requires _requestsLock
+    bool SelectParkingFloor();
+
+    // Check if any passenger is in elevator or waiting it. Requires _requestsLock
+    [[nodiscard]] inline bool HasRequests() const { return !_riders.Empty() || !_waitingUp.Empty() || !_waitingDown.Empty(); }
+
+    // Get deck stopping on floor. Always 0 for single deck car
+    [[nodiscard]] inline uint8 GetDeck(Floor floor) const { return _deckCount > 1 && _geometry.IsValidFloor(floor) ? _geometry.GetFloorIndex(floor) & 1 : 0; }
+
+    // Check if one more passenger of mass fits in deck. Requires _requestsLock
+    [[nodiscard]] bool HasDeckRoom(uint8 deck, uint32 mass) const;
+
+    // Select deck for passenger boarding on current stop. DECK_NONE if passenger doesn't fit. Requires _requestsLock
+    [[nodiscard]] uint8 SelectDeck(PassengerId id) const;
+
+    // Recalculate full flag after load change. Requires _requestsLock
+    void UpdateFull();
+
+    // Mark car state changed for cached tables and snapshot. Writers are serialized, so no read-modify-write
+    inline void BumpStateVersion() { _stateVersion.store(_stateVersion.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Copy car state in snapshot. Requires _requestsLock
+    void FillSnapshot(ElevatorSnapshot& snapshot) const;
+
+    // Publish snapshot of car state if it changed since last publish. Requires _requestsLock
+    void PublishSnapshot();
+
+    // Locks car state. Publishes snapshot before unlock, so readers never wait for car
+    class StateGuard
+    {
+    public:
+        explicit StateGuard(Elevator& elevator) : _elevator(elevator) { _elevator._requestsLock.lock(); }
+        ~StateGuard() { _elevator.PublishSnapshot(); _elevator._requestsLock.unlock(); }
+
+        StateGuard(StateGuard const&) = delete;
+        StateGuard& operator=(StateGuard const&) = delete;
+
+    private:
+        Elevator& _elevator;
+    };
+
+    // Resize passenger buckets to geometry floor count
+    void ResizeFloorRequests();
+
+    // Get passengers waiting elevator for movement direction
+    inline PassengerBuckets& GetWaiting(MovementType movementType) { return movementType == MovementType::Up ? _waitingUp : _waitingDown; }
+
+    // Get random floor between min and max floors
+    Floor GetRandomFloor();
+
+    // Floors served by elevator
+    BuildingGeometry _geometry;
 
     // Current elevator floor
-    uint8 _currentFloor{ 1 };
+    Floor _currentFloor{};
 
     // Current elevator command movement
     MovementType _movementType{};
 
-    // Queue for passengers in elevator
-    LockedQueue<ElevatorPassenger> _elevatorQueue;
+    // Count of passengers delivered to their floor
+    std::size_t _deliveredCount{};
 
-    // Queue for passengers in floors
-    LockedQueue<FloorPassenger> _floorQueue;
+    // Elevator clock. Sum of all update diffs
+    Milliseconds _clock{};
 
-    // Cancel main loop operation
-    static std::atomic<bool> _cancel;
+    // Records of all passengers in elevator and on floors
+    PassengerStore _passengers;
 
-    // Exit code for main function
-    static uint8 _exitCode;
-};
+    // Passengers in elevator by destination floor. Floors of this bucket are car calls
+    PassengerBuckets _riders{ _passengers };
+
+    // Passengers waiting to go up by current floor. Floors of this bucket are up hall calls
+    PassengerBuckets _waitingUp{ _passengers };
 
-#define sElevator Elevator::instance()
+    // Passengers waiting to go down by current floor. Floors of this bucket are down hall calls
+    PassengerBuckets _waitingDown{ _passengers };
+
+    // Count of waiting passengers by destination floor. Used by destination dispatch
+    std::vector<uint32> _waitingDestinationCounts;
+
+    // Destination floors of waiting passengers
+    FloorSet _waitingDestinations;
+
+    // Floors where car stops
+    FloorSet _servedFloors;
+
+    // Passengers left car on transfer floor and wait next car
+    std::vector<PassengerLeg> _transfers;
+
+    // Rated load of car
+    CarCapacity _capacity;
+
+    // Mass of passengers in car, kg
+    uint32 _load{};
+
+    // Count of decks. 2 - double-deck car
+    uint8 _deckCount{ 1 };
+
+    // Count and mass of passengers in every deck
+    std::array<uint32, MAX_DECK_COUNT> _deckRiders{};
+    std::array<uint32, MAX_DECK_COUNT> _deckLoads{};
+
+    // Passengers were left on floor at last stop because car was full. Reset when riders exit
+    bool _isLeftBehind{};
+
+    // Car can't take more passengers
+    bool _isFull{};
+
+    // Version of car floor, movement and stops for cached tables and snapshot. Read without lock
+    std::atomic<uint64> _stateVersion{};
+
+    // Last published snapshot. Readers load it without lock
+    std::atomic<std::shared_ptr<ElevatorSnapshot const>> _snapshot;
+
+    // Previous snapshot reused for next publish when no reader holds it
+    std::shared_ptr<ElevatorSnapshot> _spareSnapshot;
+
+    // State version of published snapshot. Guarded by _requestsLock
+    uint64 _publishedVersion{ std::numeric_limits<uint64>::max() };
+
+    // Time histograms of boarded and delivered passengers
+    PassengerStats _stats;
+
+    // Guards passengers with floor request bitsets between producers and update
+    std::mutex _requestsLock;
+
+    // Hall calls posted by producers without lock. Consumed under _requestsLock
+    Warhead::MPSCQueue<HallCall> _ingress{ INGRESS_CAPACITY };
+
+    // Selects next floor
+    AnyDispatchPolicy _dispatchPolicy;
+
+    // Recorder of new passengers
+    PassengerTraceWriter* _traceWriter{};
+
+    // Learned hall call demand for parking
+    DemandModel* _demandModel{};
+
+    // Parking floor selected when car became idle. Selected again only if demand or time bucket changes
+    bool _isParkingSelected{};
+    Floor _parkingFloor{};
+    uint32 _parkingBucket{};
+    uint64 _parkingArrivalCount{};
+
+    // Flight times of building. nullptr - car moves to next floor in one update
+    FlightTimeTable const* _flightTimes{};
+
+    // Floor of current flight
+    Floor _targetFloor{};
+
+    // Car flies to target floor
+    bool _isTravelling{};
+
+    // Clock of flight end or doors closing. Update only advances clock before it
+    Milliseconds _busyUntil{};
+
+    // Drive energy of all trips, J
+    double _energy{};
+
+    // Random generator for random passengers
+    Warhead::Xoshiro256 _generator{ std::random_device{}() };
+};
 
 #endif
@@ -0,0 +1,636 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ElevatorGroup.h"
+#include "Errors.h"
+#include "Log.h"
+#include <bit>
+#include <cstdlib>
+#include <limits>
+
+namespace
+{
+    // Cost of one extra stop for every passenger already served by car
+    constexpr uint32 STOP_COST = 2;
+
+    // Mask with bits of first count cars
+    constexpr uint64 GetCarMask(std::size_t count)
+    {
+        return count >= ElevatorGroup::MAX_CAR_COUNT ? ~uint64(0) : (uint64(1) << count) - 1;
+    }
+}
+
+ElevatorGroup::ElevatorGroup(std::size_t carCount, BuildingGeometry const& geometry /*= {}*/) :
+    _geometry(geometry)
+{
+    ASSERT(carCount, "Elevator group can't be empty");
+    ASSERT(carCount <= MAX_CAR_COUNT, "Elevator group can't have more than {} cars", MAX_CAR_COUNT);
+
+    _cars.reserve(carCount);
+
+    for (std::size_t i{}; i < carCount; i++)
+        _cars.emplace_back(std::make_unique<Elevator>(geometry));
+
+    _etaTables.resize(carCount);
+
+    SetBanks({});
+}
+
+void ElevatorGroup::Start()
+{
+    for (auto const& car : _cars)
+        car->Start();
+}
+
+void ElevatorGroup::ResetAllPassengers()
+{
+    for (auto const& car : _cars)
+        car->ResetAllPassengers();
+}
+
+std::size_t ElevatorGroup::AddPassenger(Floor currentFloor, Floor floorNeed)
+{
+    Floor legDestination{};
+    auto carIndex = SelectLegCar(currentFloor, floorNeed, legDestination);
+    if (carIndex == CAR_NONE)
+        return CAR_NONE;
+
+    LOG_DEBUG("elevator", "Hall call {} -> {} assigned to car {}. Leaves car on floor {}", currentFloor, floorNeed, carIndex, legDestination);
+
+    _cars[carIndex]->AddJourneyPassenger(currentFloor, legDestination, floorNeed);
+    return carIndex;
+}
+
+std::size_t ElevatorGroup::SelectLegCar(Floor from, Floor to, Floor& legDestination)
+{
+    auto destination = GetLegDestination(from, to);
+    if (!destination)
+    {
+        LOG_ERROR("elevator", "No cars connect floors {} and {}", from, to);
+        return CAR_NONE;
+    }
+
+    legDestination = *destination;
+    return SelectCar(FloorPassenger(from, legDestination), GetEligibleCars(from, legDestination));
+}
+
+bool ElevatorGroup::PostPassenger(Floor currentFloor, Floor floorNeed)
+{
+    return _ingress.TryPush({ currentFloor, floorNeed });
+}
+
+void ElevatorGroup::SetBanks(std::span<ElevatorBank const> banks)
+{
+    auto const floorCount = _geometry.GetFloorCount();
+    auto const allCars = GetCarMask(_cars.size());
+
+    _carBanks.assign(_cars.size(), 0);
+    _nextHops.clear();
+
+    for (auto& table : _etaTables)
+        table.Invalidate();
+
+    if (banks.empty())
+    {
+        _floorCars.assign(floorCount, allCars);
+        _bankCars.assign(1, allCars);
+
+        for (auto const& car : _cars)
+            car->SetServedFloors({});
+
+        return;
+    }
+
+    std::size_t totalCarCount{};
+    for (auto const& bank : banks)
+        totalCarCount += bank.CarCount;
+
+    ASSERT(totalCarCount == _cars.size(), "Banks have {} cars, group has {}", totalCarCount, _cars.size());
+
+    _floorCars.assign(floorCount, 0);
+    _bankCars.assign(banks.size(), 0);
+
+    std::size_t carIndex{};
+
+    for (uint32 bankIndex{}; bankIndex < banks.size(); bankIndex++)
+    {
+        auto const& bank = banks[bankIndex];
+
+        for (uint32 i{}; i < bank.CarCount; i++, carIndex++)
+        {
+            auto carBit = uint64(1) << carIndex;
+
+            _cars[carIndex]->SetServedFloors(bank.Floors);
+            _carBanks[carIndex] = bankIndex;
+            _bankCars[bankIndex] |= carBit;
+
+            for (auto floor : bank.Floors)
+                if (_geometry.IsValidFloor(floor))
+                    _floorCars[_geometry.GetFloorIndex(floor)] |= carBit;
+        }
+    }
+
+    if (banks.size() > 1)
+        BuildTransferRoutes(banks);
+}
+
+std::optional<Floor> ElevatorGroup::GetLegDestination(Floor from, Floor to) const
+{
+    if (!_geometry.IsValidFloor(from) || !_geometry.IsValidFloor(to))
+        return {};
+
+    if (_nextHops.empty())
+        return GetEligibleCars(from, to) ? std::optional<Floor>(to) : std::nullopt;
+
+    auto nextHop = _nextHops[_geometry.GetFloorIndex(from) * _geometry.GetFloorCount() + _geometry.GetFloorIndex(to)];
+    if (nextHop == FloorSet::npos)
+        return {};
+
+    return _geometry.GetFloorByIndex(nextHop);
+}
+
+std::size_t ElevatorGroup::ProcessTransfers(std::size_t carIndex)
+{
+    _transfers.clear();
+
+    if (!_cars.at(carIndex)->TakeTransfers(_transfers))
+        return 0;
+
+    std::size_t assignedCount{};
+
+    for (auto& leg : _transfers)
+    {
+        auto targetIndex = SelectLegCar(leg.Origin, leg.FinalDestination, leg.Destination);
+        if (targetIndex == CAR_NONE)
+            continue;
+
+        LOG_DEBUG("elevator", "Transfer {} -> {} on floor {} assigned to car {}", leg.JourneyOrigin, leg.FinalDestination, leg.Origin, targetIndex);
+
+        _cars[targetIndex]->AddPassengerLeg(leg);
+        assignedCount++;
+    }
+
+    return assignedCount;
+}
+
+void ElevatorGroup::BuildTransferRoutes(std::span<ElevatorBank const> banks)
+{
+    auto const floorCount = _geometry.GetFloorCount();
+
+    // Floor indexes of every bank and banks of every floor
+    std::vector<std::vector<uint32>> bankFloors(banks.size());
+    std::vector<std::vector<uint32>> floorBanks(floorCount);
+
+    for (uint32 bankIndex{}; bankIndex < banks.size(); bankIndex++)
+    {
+        for (auto floor : banks[bankIndex].Floors)
+        {
+            if (!_geometry.IsValidFloor(floor))
+                continue;
+
+            bankFloors[bankIndex].emplace_back(_geometry.GetFloorIndex(floor));
+            floorBanks[_geometry.GetFloorIndex(floor)].emplace_back(bankIndex);
+        }
+    }
+
+    // Route cost is count of cars in high bits and floors travelled in low bits
+    constexpr uint64 LEG_COST = uint64(1) << 32;
+    constexpr uint64 NO_COST = std::numeric_limits<uint64>::max();
+
+    std::vector<uint64> costs(floorCount);
+    std::vector<bool> isDone(floorCount);
+
+    _nextHops.assign(std::size_t(floorCount) * floorCount, FloorSet::npos);
+
+    // Dijkstra from every origin. Run once on bank change, floors^3 at worst
+    for (uint32 origin{}; origin < floorCount; origin++)
+    {
+        auto nextHops = _nextHops.begin() + std::size_t(origin) * floorCount;
+
+        std::fill(costs.begin(), costs.end(), NO_COST);
+        std::fill(isDone.begin(), isDone.end(), false);
+        costs[origin] = 0;
+        nextHops[origin] = origin;
+
+        for (;;)
+        {
+            uint32 floorIndex{ FloorSet::npos };
+            for (uint32 i{}; i < floorCount; i++)
+                if (!isDone[i] && costs[i] != NO_COST && (floorIndex == FloorSet::npos || costs[i] < costs[floorIndex]))
+                    floorIndex = i;
+
+            if (floorIndex == FloorSet::npos)
+                break;
+
+            isDone[floorIndex] = true;
+
+            for (auto bankIndex : floorBanks[floorIndex])
+            {
+                for (auto target : bankFloors[bankIndex])
+                {
+                    auto cost = costs[floorIndex] + LEG_COST + (target > floorIndex ? target - floorIndex : floorIndex - target);
+                    if (cost >= costs[target])
+                        continue;
+
+                    costs[target] = cost;
+                    nextHops[target] = floorIndex == origin ? target : nextHops[floorIndex];
+                }
+            }
+        }
+    }
+}
+
+std::size_t ElevatorGroup::ReassignHallCalls(std::size_t carIndex)
+{
+    auto& car = *_cars.at(carIndex);
+    auto floor = car.GetCurrentFloor();
+    auto floorIndex = _geometry.GetFloorIndex(floor);
+
+    std::size_t movedCount{};
+
+    for (auto direction : { MovementType::Up, MovementType::Down })
+    {
+        bool hasCall = car.ReadDispatchState([&](DispatchState const& state)
+        {
+            return (direction == MovementType::Up ? state.WaitingUp : state.WaitingDown).GetCount(floorIndex) != 0;
+        });
+
+        if (!hasCall)
+            continue;
+
+        // Any floor in call direction gives same hall call cost. Cars of same bank serve all destinations of call
+        auto floorNeed = static_cast<Floor>(direction == MovementType::Up ? floor + 1 : floor - 1);
+        auto targetIndex = SelectCar(FloorPassenger(floor, floorNeed), _bankCars[_carBanks[carIndex]]);
+
+        if (targetIndex != CAR_NONE && targetIndex != carIndex && car.TransferHallCall(floorIndex, direction, *_cars[targetIndex]))
+        {
+            LOG_DEBUG("elevator", "Hall call on floor {} left by full car {} reassigned to car {}", floor, carIndex, targetIndex);
+            movedCount++;
+        }
+    }
+
+    return movedCount;
+}
+
+void ElevatorGroup::AddPassengerToElevator(std::size_t carIndex, Floor floorNeed)
+{
+    _cars.at(carIndex)->AddPassengerToElevator(floorNeed);
+}
+
+void ElevatorGroup::Update(Milliseconds diff)
+{
+    // Cars reach time of this tick first, so calls posted after long idle gap aren't stamped with old clock
+    for (auto const& car : _cars)
+        car->SetClock(car->GetClock() + diff);
+
+    // Assign before update, so new calls are served in this tick
+    _ingress.ConsumeAll([this](HallCall const& call) { AddPassenger(call.CurrentFloor, call.FloorNeed); });
+
+    for (auto const& car : _cars)
+        car->Update(0ms);
+
+    for (std::size_t i{}; i < _cars.size(); i++)
+        ProcessTransfers(i);
+
+    UpdateReallocation(diff);
+}
+
+bool ElevatorGroup::IsIdle()
+{
+    if (!_ingress.Empty())
+        return false;
+
+    // Snapshots are read without lock while cars don't change
+    for (auto const& car : _cars)
+    {
+        auto snapshot = car->GetSnapshot();
+        if (car->HasPostedPassengers() || snapshot->GetPendingCount() || snapshot->IsTravelling)
+            return false;
+    }
+
+    return true;
+}
+
+void ElevatorGroup::SetClock(Milliseconds clock)
+{
+    for (auto const& car : _cars)
+        car->SetClock(clock);
+}
+
+void ElevatorGroup::SetCapacity(CarCapacity const& capacity)
+{
+    for (auto const& car : _cars)
+        car->SetCapacity(capacity);
+}
+
+void ElevatorGroup::SetDoubleDeck(bool isDoubleDeck)
+{
+    for (auto const& car : _cars)
+        car->SetDoubleDeck(isDoubleDeck);
+}
+
+void ElevatorGroup::SetEtaTiming(EtaTiming const& timing)
+{
+    _etaTiming = timing;
+
+    for (auto& table : _etaTables)
+        table.Invalidate();
+}
+
+void ElevatorGroup::SetDispatchPolicy(AnyDispatchPolicy const& policy)
+{
+    for (auto const& car : _cars)
+        car->SetDispatchPolicy(policy);
+}
+
+void ElevatorGroup::SetReallocation(CallAllocatorConfig const& config)
+{
+    if (_allocator)
+        _allocator->Cancel();
+
+    _allocator.reset();
+    _reallocationTimer = 0ms;
+
+    if (config.Interval > 0ms && _cars.size() > 1)
+        _allocator = std::make_unique<CallAllocator>(config);
+}
+
+bool ElevatorGroup::StartReallocation()
+{
+    if (!_allocator || _allocator->IsRunning())
+        return false;
+
+    FillAllocationProblem();
+    return _allocator->Start(_allocationProblem);
+}
+
+std::size_t ElevatorGroup::ApplyReallocation()
+{
+    if (!_allocator)
+        return 0;
+
+    auto plan = _allocator->TakePlan();
+    return plan ? ApplyAllocationPlan(*plan) : 0;
+}
+
+std::size_t ElevatorGroup::WaitReallocation()
+{
+    if (!_allocator)
+        return 0;
+
+    auto plan = _allocator->WaitPlan();
+    return plan ? ApplyAllocationPlan(*plan) : 0;
+}
+
+std::size_t ElevatorGroup::UpdateReallocation(Milliseconds diff)
+{
+    if (!_allocator)
+        return 0;
+
+    // Plan of search started on previous ticks
+    auto movedCount = ApplyReallocation();
+
+    _reallocationTimer += diff;
+    if (_reallocationTimer < _allocator->GetConfig().Interval)
+        return movedCount;
+
+    // Search still running is not restarted, next try after interval
+    _reallocationTimer = 0ms;
+    StartReallocation();
+    return movedCount;
+}
+
+void ElevatorGroup::SetDemandModel(DemandModel* demandModel)
+{
+    for (auto const& car : _cars)
+        car->SetDemandModel(demandModel);
+}
+
+void ElevatorGroup::SetTraceWriter(PassengerTraceWriter* writer)
+{
+    for (auto const& car : _cars)
+        car->SetTraceWriter(writer);
+}
+
+std::size_t ElevatorGroup::SelectCar(FloorPassenger const& passenger)
+{
+    if (!_geometry.IsValidFloor(passenger.CurrentFloor) || !_geometry.IsValidFloor(passenger.FloorNeed))
+        return SelectCar(passenger, GetCarMask(_cars.size()));
+
+    return SelectCar(passenger, GetEligibleCars(passenger.CurrentFloor, passenger.FloorNeed));
+}
+
+std::size_t ElevatorGroup::SelectCar(FloorPassenger const& passenger, uint64 carMask)
+{
+    std::size_t bestCar{ CAR_NONE };
+    uint32 bestCost{ std::numeric_limits<uint32>::max() };
+
+    for (auto cars = carMask & GetCarMask(_cars.size()); cars; cars &= cars - 1)
+    {
+        auto i = static_cast<std::size_t>(std::countr_zero(cars));
+        auto cost = GetAssignmentCost(i, passenger);
+        if (bestCar == CAR_NONE || cost < bestCost)
+        {
+            bestCost = cost;
+            bestCar = i;
+        }
+    }
+
+    return bestCar;
+}
+
+std::size_t ElevatorGroup::GetDeliveredCount() const
+{
+    std::size_t count{};
+
+    for (auto const& car : _cars)
+        count += car->GetDeliveredCount();
+
+    return count;
+}
+
+PassengerStats ElevatorGroup::GetStats() const
+{
+    PassengerStats stats;
+    stats.Resize(_geometry.GetFloorCount());
+
+    for (auto const& car : _cars)
+        stats.Merge(car->GetStats());
+
+    return stats;
+}
+
+void ElevatorGroup::FillAllocationProblem()
+{
+    auto& problem = _allocationProblem;
+    problem.Clear();
+    problem.Timing = _etaTiming;
+
+    // Snapshots have waiting destinations, so search input is built without car locks
+    for (std::size_t carIndex{}; carIndex < _cars.size(); carIndex++)
+    {
+        auto snapshot = _cars[carIndex]->GetSnapshot();
+
+        AllocationCar car;
+        car.FloorIndex = _geometry.GetFloorIndex(snapshot->CurrentFloor);
+        car.Movement = snapshot->Movement;
+        car.FirstRiderStop = static_cast<uint32>(problem.RiderStops.size());
+
+        auto const& riderFloors = snapshot->RiderFloors;
+        for (auto floorIndex = FloorSet::FindNext(0, riderFloors); floorIndex != FloorSet::npos; floorIndex = FloorSet::FindNext(floorIndex + 1, riderFloors))
+            problem.RiderStops.push_back({ floorIndex, snapshot->Riders[floorIndex] });
+
+        car.RiderStopCount = static_cast<uint32>(problem.RiderStops.size()) - car.FirstRiderStop;
+        problem.Cars.emplace_back(car);
+
+        auto addCalls = [&](std::vector<uint32> const& waiting, std::vector<uint32> const& destinations, MovementType direction)
+        {
+            std::size_t destinationIndex{};
+
+            for (uint32 floorIndex{}; floorIndex < waiting.size(); floorIndex++)
+            {
+                if (!waiting[floorIndex])
+                    continue;
+
+                AllocationCall call{ floorIndex, direction, waiting[floorIndex], static_cast<uint32>(carIndex) };
+                call.CarMask = _bankCars[_carBanks[carIndex]];
+                call.FirstDestinationStop = static_cast<uint32>(problem.DestinationStops.size());
+
+                // Stops on same floor are merged by search
+                for (uint32 i{}; i < waiting[floorIndex]; i++)
+                    problem.DestinationStops.push_back({ destinations[destinationIndex++], 1 });
+
+                call.DestinationStopCount = static_cast<uint32>(problem.DestinationStops.size()) - call.FirstDestinationStop;
+                problem.Calls.emplace_back(call);
+            }
+        };
+
+        addCalls(snapshot->WaitingUp, snapshot->WaitingUpDestinations, MovementType::Up);
+        addCalls(snapshot->WaitingDown, snapshot->WaitingDownDestinations, MovementType::Down);
+    }
+}
+
+std::size_t ElevatorGroup::ApplyAllocationPlan(AllocationPlan const& plan)
+{
+    std::size_t movedCount{};
+
+    for (auto const& move : plan.Moves)
+    {
+        if (move.FromCar >= _cars.size() || move.ToCar >= _cars.size() || move.FloorIndex >= _geometry.GetFloorCount())
+            continue;
+
+        if (_cars[move.FromCar]->TransferHallCall(move.FloorIndex, move.Direction, *_cars[move.ToCar]))
+            movedCount++;
+    }
+
+    LOG_DEBUG("elevator", "Reallocation moved {} of {} hall calls. Cost {} -> {}", movedCount, plan.Moves.size(), plan.InitialCost, plan.Cost);
+
+    _reallocatedCount += movedCount;
+    return movedCount;
+}
+
+uint32 ElevatorGroup::GetAssignmentCost(std::size_t carIndex, FloorPassenger const& passenger)
+{
+    return _costFunction == GroupCostFunction::Eta ? GetEtaCost(carIndex, passenger) : GetDistanceCost(carIndex, passenger);
+}
+
+bool ElevatorGroup::IsOverloaded(Elevator const& car, ElevatorSnapshot const& snapshot, uint32 pending) const
+{
+    auto const& capacity = car.GetCapacity();
+    return snapshot.IsFull || (capacity.Persons && pending >= capacity.Persons);
+}
+
+uint32 ElevatorGroup::GetPendingCount(std::size_t carIndex, ElevatorSnapshot const& snapshot) const
+{
+    auto pending = snapshot.GetPendingCount();
+    if (!_queuedCounts.empty())
+        pending += _queuedCounts[carIndex].load(std::memory_order_acquire);
+
+    return pending;
+}
+
+uint32 ElevatorGroup::GetDistanceCost(std::size_t carIndex, FloorPassenger const& passenger) const
+{
+    auto& car = *_cars[carIndex];
+    auto snapshot = car.GetSnapshot();
+    auto carFloor = snapshot->CurrentFloor;
+    auto callFloor = passenger.CurrentFloor;
+    auto pending = GetPendingCount(carIndex, *snapshot);
+    uint32 cost = static_cast<uint32>(std::abs(carFloor - callFloor));
+
+    // Car is busy and moving away from hall call
+    if (pending)
+    {
+        bool isAhead = snapshot->Movement == MovementType::Up ? callFloor >= carFloor : callFloor <= carFloor;
+        // Car must turn around before it can reach hall call
+        if (!isAhead)
+            cost += 2 * (_geometry.GetFloorCount() - 1);
+    }
+
+    // New stop delays all passengers already served by car
+    if (!snapshot->HasStopAt(_geometry.GetFloorIndex(callFloor)))
+        cost += STOP_COST * (pending + 1);
+
+    // No place for passenger. Car must deliver riders and come back
+    if (IsOverloaded(car, *snapshot, pending))
+        cost += 2 * (_geometry.GetFloorCount() - 1);
+
+    // Destination is known at hall. Prefer car already stopping at or near destination
+    if (_assignmentMode == GroupAssignmentMode::Destination)
+    {
+        auto distance = snapshot->GetDestinationStopDistance(_geometry.GetFloorIndex(passenger.FloorNeed));
+        if (!distance || *distance)
+            cost += STOP_COST * (pending + 1) + distance.value_or(0);
+    }
+
+    return cost;
+}
+
+uint32 ElevatorGroup::GetEtaCost(std::size_t carIndex, FloorPassenger const& passenger)
+{
+    auto& car = *_cars[carIndex];
+    auto& table = _etaTables[carIndex];
+
+    car.UpdateEtaTable(table, _etaTiming);
+
+    auto callFloor = passenger.CurrentFloor;
+    auto direction = passenger.FloorNeed >= callFloor ? MovementType::Up : MovementType::Down;
+    auto snapshot = car.GetSnapshot();
+    auto pending = GetPendingCount(carIndex, *snapshot);
+    auto stopTime = static_cast<uint32>(_etaTiming.StopTime.count());
+
+    uint32 cost = static_cast<uint32>(table.Get(_geometry.GetFloorIndex(callFloor), direction).count());
+
+    // New stop delays all passengers already served by car
+    if (!snapshot->HasStopAt(_geometry.GetFloorIndex(callFloor)))
+        cost += stopTime * pending;
+
+    // No place for passenger. Car must deliver riders and come back
+    if (IsOverloaded(car, *snapshot, pending))
+        cost += 2 * (_geometry.GetFloorCount() - 1) * static_cast<uint32>(_etaTiming.FloorTravelTime.count()) + stopTime * pending;
+
+    // Destination is known at hall. New destination stop delays passengers in car
+    if (_assignmentMode == GroupAssignmentMode::Destination)
+    {
+        auto distance = snapshot->GetDestinationStopDistance(_geometry.GetFloorIndex(passenger.FloorNeed));
+        if (!distance || *distance)
+            cost += stopTime * pending + distance.value_or(0) * static_cast<uint32>(_etaTiming.FloorTravelTime.count());
+    }
+
+    return cost;
+}
@@ -0,0 +1,259 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_ELEVATOR_GROUP_H_
+#define WARHEAD_ELEVATOR_GROUP_H_
+
+#include "CallAllocator.h"
+#include "Elevator.h"
+#include "ElevatorBank.h"
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <span>
+#include <vector>
+
+// How group assigns hall calls to cars
+enum class GroupAssignmentMode : uint8
+{
+    Collective,     // Up and down hall buttons. Car is selected by hall call only
+    Destination     // Destination entered at hall. Passengers with same or nearby destinations share car
+};
+
+// Cost of assigning hall call to car
+enum class GroupCostFunction : uint8
+{
+    Distance,   // Floors to hall call with penalties for turn around and extra stops
+    Eta         // Estimated time of car arrival with delay of passengers already served by car
+};
+
+// Bank of elevator cars with one dispatcher for all hall calls
+class WH_CTRL_API ElevatorGroup
+{
+public:
+    // Returned by car selection if no car serves both floors
+    static constexpr std::size_t CAR_NONE = std::numeric_limits<std::size_t>::max();
+
+    // Cars of group are bits of one 64 bit mask
+    static constexpr std::size_t MAX_CAR_COUNT = 64;
+
+    // Hall calls posted between two updates
+    static constexpr std::size_t INGRESS_CAPACITY = 4096;
+
+    explicit ElevatorGroup(std::size_t carCount, BuildingGeometry const& geometry = {});
+    ~ElevatorGroup() = default;
+
+    ElevatorGroup(ElevatorGroup const&) = delete;
+    ElevatorGroup& operator=(ElevatorGroup const&) = delete;
+
+    // Default start. Add random passengers on floors
+    void Start();
+
+    // Reset all queues in all cars
+    void ResetAllPassengers();
+
+    // Assign hall call to one car. Passenger going to floor of other bank rides to transfer floor first.
+    // Returns index of assigned car or CAR_NONE if no cars connect floors
+    std::size_t AddPassenger(Floor currentFloor, Floor floorNeed);
+
+    // Post hall call from any thread without lock. Call is assigned to car by next Update in one batch.
+    // Returns false if ingress queue is full, call must be posted again after update
+    bool PostPassenger(Floor currentFloor, Floor floorNeed);
+
+    // Split cars in banks serving own floors. Car counts of banks must sum to group car count. Empty - all cars serve all floors
+    void SetBanks(std::span<ElevatorBank const> banks);
+
+    // Get bank of car
+    [[nodiscard]] inline uint32 GetBankIndex(std::size_t carIndex) const { return _carBanks[carIndex]; }
+
+    // Get mask of cars stopping on both floors. One AND of floor masks
+    [[nodiscard]] inline uint64 GetEligibleCars(Floor from, Floor to) const
+    {
+        return _floorCars[_geometry.GetFloorIndex(from)] & _floorCars[_geometry.GetFloorIndex(to)];
+    }
+
+    // Get floor where passenger leaves first car on way from floor to destination. Destination if one car goes there. Empty - no route
+    [[nodiscard]] std::optional<Floor> GetLegDestination(Floor from, Floor to) const;
+
+    // Select car for first leg of way from floor to destination and set floor where passenger leaves it. Cars are not changed.
+    // Returns CAR_NONE if no cars connect floors
+    std::size_t SelectLegCar(Floor from, Floor to, Floor& legDestination);
+
+    // Assign next legs of passengers who left car on transfer floor. Returns count of assigned passengers
+    std::size_t ProcessTransfers(std::size_t carIndex);
+
+    // Move hall calls left on current floor of car to other cars. Used when full car leaves passengers. Returns count of moved hall calls
+    std::size_t ReassignHallCalls(std::size_t carIndex);
+
+    // Add passenger in car with index
+    void AddPassengerToElevator(std::size_t carIndex, Floor floorNeed);
+
+    // Assign posted hall calls, update all cars and run reallocation
+    void Update(Milliseconds diff);
+
+    // Check if no hall calls are posted and no car has passengers or travels. Idle group can skip updates. Not while Update runs
+    [[nodiscard]] bool IsIdle();
+
+    // Set clock of all cars. Used by event driven simulation
+    void SetClock(Milliseconds clock);
+
+    // Change how hall calls are assigned to cars
+    inline void SetAssignmentMode(GroupAssignmentMode mode) { _assignmentMode = mode; }
+
+    [[nodiscard]] inline GroupAssignmentMode GetAssignmentMode() const { return _assignmentMode; }
+
+    // Change cost of assigning hall call to car
+    inline void SetCostFunction(GroupCostFunction costFunction) { _costFunction = costFunction; }
+
+    [[nodiscard]] inline GroupCostFunction GetCostFunction() const { return _costFunction; }
+
+    // Change rated load of all cars
+    void SetCapacity(CarCapacity const& capacity);
+
+    // Couple second deck to all cars
+    void SetDoubleDeck(bool isDoubleDeck);
+
+    // Change time model of ETA cost
+    void SetEtaTiming(EtaTiming const& timing);
+
+    // Change policy selecting next floor of all cars
+    void SetDispatchPolicy(AnyDispatchPolicy const& policy);
+
+    // Enable periodic reallocation of hall calls between cars. Interval 0 - disable
+    void SetReallocation(CallAllocatorConfig const& config);
+
+    // Start reallocation search over snapshot of cars. Never blocks. Returns false if disabled or search is running
+    bool StartReallocation();
+
+    // Move hall calls by published reallocation plan. Never blocks. Returns count of moved hall calls
+    std::size_t ApplyReallocation();
+
+    // Wait running reallocation search and move hall calls by its plan. Used by virtual time simulation
+    std::size_t WaitReallocation();
+
+    // Real time reallocation tick. Move hall calls by finished search and start next search every interval. Never blocks.
+    // Returns count of moved hall calls
+    std::size_t UpdateReallocation(Milliseconds diff);
+
+    [[nodiscard]] inline bool IsReallocationEnabled() const { return _allocator != nullptr; }
+
+    // Get count of hall calls moved by reallocation
+    [[nodiscard]] inline std::size_t GetReallocatedCount() const { return _reallocatedCount; }
+
+    // Learn hall calls of all cars in one demand model. nullptr - stop learning
+    void SetDemandModel(DemandModel* demandModel);
+
+    // Record new passengers of all cars in one trace. nullptr - stop recording
+    void SetTraceWriter(PassengerTraceWriter* writer);
+
+    // Count passengers sent to cars by messages and not added yet as pending in assignment cost. One count per car. Empty - none
+    inline void SetQueuedCounts(std::span<std::atomic<uint32> const> queuedCounts) { _queuedCounts = queuedCounts; }
+
+    // Select best car for hall call. CAR_NONE if no car serves both floors
+    std::size_t SelectCar(FloorPassenger const& passenger);
+
+    // Select best car of mask for hall call. CAR_NONE if mask is empty
+    std::size_t SelectCar(FloorPassenger const& passenger, uint64 carMask);
+
+    // Get car by index
+    [[nodiscard]] Elevator* GetCar(std::size_t carIndex) const { return _cars.at(carIndex).get(); }
+
+    // Get count of cars in group
+    [[nodiscard]] inline std::size_t GetCarCount() const { return _cars.size(); }
+
+    // Get floors served by all cars
+    [[nodiscard]] inline BuildingGeometry const& GetGeometry() const { return _geometry; }
+
+    // Get count of passengers delivered by all cars
+    [[nodiscard]] std::size_t GetDeliveredCount() const;
+
+    // Merge passenger time histograms of all cars. Call when no car updates
+    [[nodiscard]] PassengerStats GetStats() const;
+
+private:
+    // Fill reallocation snapshot with car positions, car calls and hall calls with passenger destinations
+    void FillAllocationProblem();
+
+    // Move hall calls by plan. Calls served by other cars since snapshot are skipped
+    std::size_t ApplyAllocationPlan(AllocationPlan const& plan);
+
+    // Build next transfer floor for all floor pairs. Fewest cars first, then shortest travel
+    void BuildTransferRoutes(std::span<ElevatorBank const> banks);
+
+    // Get cost of assign hall call to car. Lower is better
+    uint32 GetAssignmentCost(std::size_t carIndex, FloorPassenger const& passenger);
+
+    // Check if car can't take passenger of new hall call: car is full or has more riders and waiting passengers than places
+    [[nodiscard]] bool IsOverloaded(Elevator const& car, ElevatorSnapshot const& snapshot, uint32 pending) const;
+
+    // Get count of passengers in car, waiting it and sent to it but not added yet
+    [[nodiscard]] uint32 GetPendingCount(std::size_t carIndex, ElevatorSnapshot const& snapshot) const;
+
+    // Distance cost in floors. All car state is read from one snapshot
+    uint32 GetDistanceCost(std::size_t carIndex, FloorPassenger const& passenger) const;
+
+    // ETA cost in milliseconds. All car state is read from one snapshot
+    uint32 GetEtaCost(std::size_t carIndex, FloorPassenger const& passenger);
+
+    // Floors served by all cars
+    BuildingGeometry _geometry;
+
+    // All cars in group
+    std::vector<std::unique_ptr<Elevator>> _cars;
+
+    GroupAssignmentMode _assignmentMode{ GroupAssignmentMode::Collective };
+    GroupCostFunction _costFunction{ GroupCostFunction::Distance };
+
+    // ETA of every car. Rebuilt only when car state version changes
+    std::vector<EtaTable> _etaTables;
+    EtaTiming _etaTiming;
+
+    // Background search of better hall call assignment. nullptr - disabled
+    std::unique_ptr<CallAllocator> _allocator;
+
+    // Snapshot buffer for next search. Swapped with buffer of allocator
+    AllocationProblem _allocationProblem;
+
+    // Time since last real time search start
+    Milliseconds _reallocationTimer{};
+
+    std::size_t _reallocatedCount{};
+
+    // Mask of cars stopping on floor by floor index
+    std::vector<uint64> _floorCars;
+
+    // Bank of every car
+    std::vector<uint32> _carBanks;
+
+    // Mask of cars of every bank
+    std::vector<uint64> _bankCars;
+
+    // Floor index of first leg destination by origin and destination floor indexes. Empty - one bank
+    std::vector<uint32> _nextHops;
+
+    // Passengers sent to cars and not added yet. Empty - cars are changed directly
+    std::span<std::atomic<uint32> const> _queuedCounts;
+
+    // Passengers on transfer floors. Reused between calls
+    std::vector<PassengerLeg> _transfers;
+
+    // Hall calls posted by producers without lock. Consumed by Update
+    Warhead::MPSCQueue<HallCall> _ingress{ INGRESS_CAPACITY };
+};
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ElevatorSnapshot.h"
+#include <algorithm>
+
+bool ElevatorSnapshot::HasStopAt(uint32 floorIndex) const
+{
+    if (floorIndex >= Riders.size())
+        return false;
+
+    // Double-deck car stops on lower floor of pair
+    auto stopIndex = DeckCount > 1 ? floorIndex & ~uint32(1) : floorIndex;
+    auto stopFloorCount = std::min<uint32>(DeckCount, static_cast<uint32>(Riders.size()) - stopIndex);
+
+    for (uint32 i{}; i < stopFloorCount; i++)
+        if (Riders[stopIndex + i] || WaitingUp[stopIndex + i] || WaitingDown[stopIndex + i])
+            return true;
+
+    return false;
+}
+
+std::optional<uint32> ElevatorSnapshot::GetDestinationStopDistance(uint32 floorIndex) const
+{
+    if (floorIndex >= Riders.size())
+        return {};
+
+    auto nextFloorUp = FloorSet::FindNext(floorIndex, RiderFloors, WaitingDestinations);
+    auto nextFloorDown = FloorSet::FindPrev(floorIndex, RiderFloors, WaitingDestinations);
+
+    if (nextFloorUp == FloorSet::npos && nextFloorDown == FloorSet::npos)
+        return {};
+
+    if (nextFloorDown == FloorSet::npos)
+        return static_cast<uint32>(nextFloorUp - floorIndex);
+
+    if (nextFloorUp == FloorSet::npos)
+        return static_cast<uint32>(floorIndex - nextFloorDown);
+
+    return static_cast<uint32>(std::min(nextFloorUp - floorIndex, floorIndex - nextFloorDown));
+}
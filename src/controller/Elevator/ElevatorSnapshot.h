@@ -0,0 +1,71 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_ELEVATOR_SNAPSHOT_H_
+#define WARHEAD_ELEVATOR_SNAPSHOT_H_
+
+#include "Building.h"
+#include "DispatchPolicy.h"
+#include "FloorSet.h"
+#include <optional>
+#include <vector>
+
+// Immutable view of car at one state version. Readers share it without lock while car keeps changing.
+// Counts are by floor index
+struct WH_CTRL_API ElevatorSnapshot
+{
+    // Count of passengers in car and waiting it
+    [[nodiscard]] inline uint32 GetPendingCount() const { return RidingCount + WaitingCount; }
+
+    // Check if car will stop at floor for any passenger. Double-deck car stops for both floors of pair at once
+    [[nodiscard]] bool HasStopAt(uint32 floorIndex) const;
+
+    // Get distance in floors to nearest destination of passengers in car or waiting it. 0 - car will stop at floor for passenger destination. Empty - no destinations
+    [[nodiscard]] std::optional<uint32> GetDestinationStopDistance(uint32 floorIndex) const;
+
+    // Car state version of snapshot
+    uint64 Version{};
+
+    Floor CurrentFloor{};
+    MovementType Movement{};
+    bool IsTravelling{};
+    bool IsFull{};
+    uint8 DeckCount{ 1 };
+
+    // Mass of passengers in car, kg
+    uint32 Load{};
+
+    uint32 RidingCount{};
+    uint32 WaitingCount{};
+    std::size_t DeliveredCount{};
+
+    // Passengers in car by destination floor and waiting by current floor
+    std::vector<uint32> Riders;
+    std::vector<uint32> WaitingUp;
+    std::vector<uint32> WaitingDown;
+
+    // Destination floor indexes of waiting passengers. Grouped by current floor in floor order, WaitingUp[i] or WaitingDown[i] ones for floor i
+    std::vector<uint32> WaitingUpDestinations;
+    std::vector<uint32> WaitingDownDestinations;
+
+    // Destination floors of passengers in car and waiting passengers
+    FloorSet RiderFloors;
+    FloorSet WaitingDestinations;
+};
+
+#endif
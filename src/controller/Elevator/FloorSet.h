@@ -0,0 +1,128 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_FLOOR_SET_H_
+#define WARHEAD_FLOOR_SET_H_
+
+#include "Define.h"
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <vector>
+
+// Set of floors stored as bitset. Bit index is zero based floor index (see BuildingGeometry::GetFloorIndex)
+class FloorSet
+{
+    static constexpr uint32 WORD_BITS = 64;
+
+public:
+    // Returned by search if no floor found
+    static constexpr uint32 npos = std::numeric_limits<uint32>::max();
+
+    FloorSet() = default;
+    explicit FloorSet(uint32 size) { Resize(size); }
+
+    // Change count of floors. Clear all floors
+    void Resize(uint32 size)
+    {
+        _size = size;
+        _words.assign((size + WORD_BITS - 1) / WORD_BITS, 0);
+    }
+
+    // Clear all floors
+    void Clear() { std::fill(_words.begin(), _words.end(), 0); }
+
+    inline void Set(uint32 index) { _words[index / WORD_BITS] |= GetBit(index); }
+    inline void Reset(uint32 index) { _words[index / WORD_BITS] &= ~GetBit(index); }
+    [[nodiscard]] inline bool Test(uint32 index) const { return _words[index / WORD_BITS] & GetBit(index); }
+
+    // Check if any floor is set
+    [[nodiscard]] bool Any() const
+    {
+        for (auto word : _words)
+            if (word)
+                return true;
+
+        return false;
+    }
+
+    // Count of floors in set
+    [[nodiscard]] inline uint32 Size() const { return _size; }
+
+    // Raw bitset words. Bit N of word W is floor index W * 64 + N
+    [[nodiscard]] inline std::vector<uint64> const& GetWords() const { return _words; }
+
+    // Find lowest floor index >= from in union of all sets. All sets must have same size
+    template<class... Sets>
+    [[nodiscard]] static uint32 FindNext(uint32 from, FloorSet const& set, Sets const&... sets)
+    {
+        if (from >= set._size)
+            return npos;
+
+        std::size_t word = from / WORD_BITS;
+        uint64 bits = GetUnionWord(word, set, sets...) & (~uint64(0) << (from % WORD_BITS));
+
+        while (!bits)
+        {
+            if (++word >= set._words.size())
+                return npos;
+
+            bits = GetUnionWord(word, set, sets...);
+        }
+
+        return static_cast<uint32>(word * WORD_BITS + std::countr_zero(bits));
+    }
+
+    // Find highest floor index <= from in union of all sets. All sets must have same size
+    template<class... Sets>
+    [[nodiscard]] static uint32 FindPrev(uint32 from, FloorSet const& set, Sets const&... sets)
+    {
+        if (from == npos || !set._size)
+            return npos;
+
+        if (from >= set._size)
+            from = set._size - 1;
+
+        std::size_t word = from / WORD_BITS;
+        uint64 bits = GetUnionWord(word, set, sets...) & (~uint64(0) >> (WORD_BITS - 1 - from % WORD_BITS));
+
+        while (!bits)
+        {
+            if (!word--)
+                return npos;
+
+            bits = GetUnionWord(word, set, sets...);
+        }
+
+        return static_cast<uint32>(word * WORD_BITS + WORD_BITS - 1 - std::countl_zero(bits));
+    }
+
+private:
+    static constexpr uint64 GetBit(uint32 index) { return uint64(1) << (index % WORD_BITS); }
+
+    template<class... Sets>
+    static inline uint64 GetUnionWord(std::size_t word, Sets const&... sets)
+    {
+        return (sets._words[word] | ...);
+    }
+
+    std::vector<uint64> _words;
+    uint32 _size{};
+};
+
+#endif
@@ -0,0 +1,226 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "GroupController.h"
+#include "DemandModel.h"
+#include "Log.h"
+#include "PassengerTrace.h"
+
+GroupController::GroupController(ElevatorGroup& group, DemandModel* demandModel /*= nullptr*/, PassengerTraceWriter* traceWriter /*= nullptr*/) :
+    _group(group), _demandModel(demandModel), _traceWriter(traceWriter), _tickDiffs(group.GetCarCount()), _queuedCounts(group.GetCarCount()),
+    _transfers(group.GetCarCount()), _idleReported(group.GetCarCount()), _parkingFloors(group.GetCarCount())
+{
+    _parkedFloors.reserve(group.GetCarCount());
+
+    // Dispatcher doesn't see passengers of mailbox in car snapshot
+    _group.SetQueuedCounts(_queuedCounts);
+
+    _cars.reserve(group.GetCarCount());
+
+    for (std::size_t i{}; i < group.GetCarCount(); i++)
+        _cars.emplace_back(std::make_unique<Warhead::Actor<CarMessage>>(MAILBOX_CAPACITY, [this, i](CarMessage const& message) { ReceiveCar(i, message); }));
+
+    _dispatcher = std::make_unique<Warhead::Actor<DispatcherMessage>>(MAILBOX_CAPACITY, [this](DispatcherMessage const& message) { ReceiveDispatcher(message); });
+
+    LOG_INFO("elevator", "Group controller started {} car actors", _cars.size());
+}
+
+GroupController::~GroupController()
+{
+    Stop();
+}
+
+void GroupController::PostPassenger(Floor currentFloor, Floor floorNeed, uint16 mass /*= DEFAULT_PASSENGER_MASS*/)
+{
+    SendToDispatcher(HallCall{ currentFloor, floorNeed, mass });
+}
+
+void GroupController::Update(Milliseconds diff)
+{
+    _clock.fetch_add(diff.count(), std::memory_order_relaxed);
+
+    for (std::size_t i{}; i < _cars.size(); i++)
+        if (!_tickDiffs[i].fetch_add(diff.count(), std::memory_order_acq_rel))
+            SendToCar(i, CarTick{});
+
+    if (_group.IsReallocationEnabled() && !_reallocationDiff.fetch_add(diff.count(), std::memory_order_acq_rel))
+        SendToDispatcher(ReallocationTick{});
+}
+
+void GroupController::Wait()
+{
+    for (;;)
+    {
+        auto pendingCount = _pendingCount.load(std::memory_order_acquire);
+        if (!pendingCount)
+            return;
+
+        _pendingCount.wait(pendingCount, std::memory_order_acquire);
+    }
+}
+
+void GroupController::Stop()
+{
+    // Cars and dispatcher send to each other. Stopped actor only queues messages
+    if (_dispatcher)
+        _dispatcher->Stop();
+
+    for (auto const& car : _cars)
+        car->Stop();
+
+    _group.SetQueuedCounts({});
+}
+
+void GroupController::SendToCar(std::size_t carIndex, CarMessage const& message)
+{
+    // Counted before send, so sender handling own message keeps count above zero
+    _pendingCount.fetch_add(1, std::memory_order_relaxed);
+    _cars[carIndex]->Send(message);
+}
+
+void GroupController::SendToDispatcher(DispatcherMessage const& message)
+{
+    _pendingCount.fetch_add(1, std::memory_order_relaxed);
+    _dispatcher->Send(message);
+}
+
+void GroupController::ReceiveCar(std::size_t carIndex, CarMessage const& message)
+{
+    auto& car = *_group.GetCar(carIndex);
+
+    if (std::holds_alternative<CarTick>(message))
+    {
+        car.Update(Milliseconds(_tickDiffs[carIndex].exchange(0, std::memory_order_acq_rel)));
+
+        // Next leg is assigned by dispatcher
+        auto& transfers = _transfers[carIndex];
+        transfers.clear();
+        car.TakeTransfers(transfers);
+
+        for (auto const& leg : transfers)
+            SendToDispatcher(leg);
+
+        // Report idle car once until it gets new work
+        if (_demandModel)
+        {
+            if (!car.IsIdle())
+                _idleReported[carIndex] = false;
+            else if (!_idleReported[carIndex])
+            {
+                _idleReported[carIndex] = true;
+                SendToDispatcher(CarIdle{ static_cast<uint32>(carIndex) });
+            }
+        }
+    }
+    else if (auto parking = std::get_if<CarParking>(&message))
+        car.Park(parking->ParkingFloor);
+    else
+    {
+        if (auto assignment = std::get_if<CarAssignment>(&message))
+            car.AddJourneyPassenger(assignment->CurrentFloor, assignment->LegDestination, assignment->FinalDestination, assignment->Mass);
+        else
+            car.AddPassengerLeg(std::get<PassengerLeg>(message));
+
+        _queuedCounts[carIndex].fetch_sub(1, std::memory_order_release);
+    }
+
+    Done();
+}
+
+void GroupController::ReceiveDispatcher(DispatcherMessage const& message)
+{
+    if (auto call = std::get_if<HallCall>(&message))
+    {
+        Floor legDestination{};
+        auto carIndex = _group.SelectLegCar(call->CurrentFloor, call->FloorNeed, legDestination);
+
+        if (carIndex != ElevatorGroup::CAR_NONE)
+        {
+            auto clock = Milliseconds(_clock.load(std::memory_order_relaxed));
+
+            if (_traceWriter)
+                _traceWriter->Record(clock, call->CurrentFloor, call->FloorNeed);
+
+            if (_demandModel)
+                _demandModel->AddArrival(clock, call->CurrentFloor);
+
+            LOG_DEBUG("elevator", "Hall call {} -> {} assigned to car {}. Leaves car on floor {}", call->CurrentFloor, call->FloorNeed, carIndex, legDestination);
+            _queuedCounts[carIndex].fetch_add(1, std::memory_order_release);
+            SendToCar(carIndex, CarAssignment{ call->CurrentFloor, legDestination, call->FloorNeed, call->Mass });
+        }
+    }
+    else if (auto idle = std::get_if<CarIdle>(&message))
+        ParkCar(idle->CarIndex);
+    else if (std::holds_alternative<ReallocationTick>(message))
+        _group.UpdateReallocation(Milliseconds(_reallocationDiff.exchange(0, std::memory_order_acq_rel)));
+    else
+    {
+        auto leg = std::get<PassengerLeg>(message);
+        auto carIndex = _group.SelectLegCar(leg.Origin, leg.FinalDestination, leg.Destination);
+
+        if (carIndex != ElevatorGroup::CAR_NONE)
+        {
+            LOG_DEBUG("elevator", "Transfer {} -> {} on floor {} assigned to car {}", leg.JourneyOrigin, leg.FinalDestination, leg.Origin, carIndex);
+            _queuedCounts[carIndex].fetch_add(1, std::memory_order_release);
+            SendToCar(carIndex, leg);
+        }
+    }
+
+    Done();
+}
+
+void GroupController::ParkCar(uint32 carIndex)
+{
+    auto car = _group.GetCar(carIndex);
+    auto snapshot = car->GetSnapshot();
+
+    // Car got passenger after it reported idle
+    if (snapshot->GetPendingCount() || snapshot->IsTravelling || _queuedCounts[carIndex].load(std::memory_order_acquire))
+        return;
+
+    _parkedFloors.clear();
+
+    for (uint32 i{}; i < _group.GetCarCount(); i++)
+    {
+        // Cars of other banks don't cover calls of this car
+        if (i == carIndex || _group.GetBankIndex(i) != _group.GetBankIndex(carIndex))
+            continue;
+
+        auto other = _group.GetCar(i)->GetSnapshot();
+        if (other->GetPendingCount() || _queuedCounts[i].load(std::memory_order_acquire))
+            continue;
+
+        // Travelling car without passengers goes to parking floor
+        _parkedFloors.emplace_back(other->IsTravelling ? _parkingFloors[i] : other->CurrentFloor);
+    }
+
+    auto clock = Milliseconds(_clock.load(std::memory_order_relaxed));
+    auto parkingFloor = car->GetStopFloor(_demandModel->GetParkingFloor(clock, snapshot->CurrentFloor, _parkedFloors, &car->GetServedFloors()));
+
+    if (parkingFloor == snapshot->CurrentFloor)
+        return;
+
+    _parkingFloors[carIndex] = parkingFloor;
+    SendToCar(carIndex, CarParking{ parkingFloor });
+}
+
+void GroupController::Done()
+{
+    if (_pendingCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        _pendingCount.notify_all();
+}
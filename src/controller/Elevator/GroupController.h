@@ -0,0 +1,146 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_GROUP_CONTROLLER_H_
+#define WARHEAD_GROUP_CONTROLLER_H_
+
+#include "Actor.h"
+#include "ElevatorGroup.h"
+#include <atomic>
+#include <memory>
+#include <variant>
+#include <vector>
+
+class DemandModel;
+class PassengerTraceWriter;
+
+// Clock tick of car. Time of all ticks sent since last update of car is taken at once
+struct CarTick { };
+
+// New passenger assigned to car by dispatcher
+struct CarAssignment
+{
+    Floor CurrentFloor{};
+    Floor LegDestination{};
+    Floor FinalDestination{};
+    uint16 Mass{ DEFAULT_PASSENGER_MASS };
+};
+
+// Idle car sent by dispatcher to parking floor
+struct CarParking
+{
+    Floor ParkingFloor{};
+};
+
+// Car became idle. Dispatcher selects its parking floor
+struct CarIdle
+{
+    uint32 CarIndex{};
+};
+
+// Clock tick of reallocation. Time of all ticks sent since last reallocation update is taken at once
+struct ReallocationTick { };
+
+// Messages of car actor
+using CarMessage = std::variant<CarTick, CarAssignment, PassengerLeg, CarParking>;
+
+// Messages of dispatcher actor: new hall calls, passengers left car on transfer floor, idle cars and reallocation ticks
+using DispatcherMessage = std::variant<HallCall, PassengerLeg, CarIdle, ReallocationTick>;
+
+// Runs every car of group as actor on own thread. Dispatcher actor assigns hall calls and transfers and sends stop assignments to cars.
+// Cars update in parallel, slow car doesn't delay others. Dispatcher reads cars only by snapshots.
+// Dispatcher sees every hall call, so it alone records trace and feeds demand model used for parking of idle cars.
+// Dispatcher also starts reallocation searches of group and moves hall calls by their plans.
+// Group must not be changed while controller runs
+class WH_CTRL_API GroupController
+{
+public:
+    // Messages queued in mailbox without lock
+    static constexpr std::size_t MAILBOX_CAPACITY = 1024;
+
+    // Start car and dispatcher threads. Demand model and trace writer are used only by dispatcher, cars of group must not have them
+    explicit GroupController(ElevatorGroup& group, DemandModel* demandModel = nullptr, PassengerTraceWriter* traceWriter = nullptr);
+
+    // Stop all threads. Messages not handled yet are dropped
+    ~GroupController();
+
+    GroupController(GroupController const&) = delete;
+    GroupController& operator=(GroupController const&) = delete;
+
+    // Post hall call from any thread. Dispatcher assigns it to car
+    void PostPassenger(Floor currentFloor, Floor floorNeed, uint16 mass = DEFAULT_PASSENGER_MASS);
+
+    // Send clock tick to all cars and to dispatcher if reallocation is enabled. Never waits actors. Busy car gets time of several ticks in its next update
+    void Update(Milliseconds diff);
+
+    // Block until all actors handled all messages, including messages sent by actors. Call before Stop
+    void Wait();
+
+    // Stop all threads. Group can be read after stop
+    void Stop();
+
+    [[nodiscard]] inline ElevatorGroup& GetGroup() { return _group; }
+
+private:
+    void SendToCar(std::size_t carIndex, CarMessage const& message);
+    void SendToDispatcher(DispatcherMessage const& message);
+
+    // Handlers run on actor threads
+    void ReceiveCar(std::size_t carIndex, CarMessage const& message);
+    void ReceiveDispatcher(DispatcherMessage const& message);
+
+    // Send idle car to floor of likely next hall call. Runs on dispatcher thread
+    void ParkCar(uint32 carIndex);
+
+    // Mark message handled. Wakes Wait when no messages left
+    void Done();
+
+    ElevatorGroup& _group;
+    DemandModel* _demandModel{};
+    PassengerTraceWriter* _traceWriter{};
+
+    // Sum of tick time, time of dispatcher
+    std::atomic<int64> _clock{};
+
+    // Count of messages sent and not handled by all actors
+    std::atomic<uint64> _pendingCount{};
+
+    // Tick time not taken by car yet, ms. Tick message is sent only when it was 0
+    std::vector<std::atomic<int64>> _tickDiffs;
+
+    // Tick time not taken by reallocation of dispatcher yet, ms
+    std::atomic<int64> _reallocationDiff{};
+
+    // Passengers sent to car and not added yet. Counted by dispatcher as pending in assignment cost
+    std::vector<std::atomic<uint32>> _queuedCounts;
+
+    // Passengers left car on transfer floor. One buffer per car actor
+    std::vector<std::vector<PassengerLeg>> _transfers;
+
+    // Car reported idle since it got last work. Written only by car actor
+    std::vector<uint8> _idleReported;
+
+    // Parking floor of every car and floors of other idle cars. Used only by dispatcher
+    std::vector<Floor> _parkingFloors;
+    std::vector<Floor> _parkedFloors;
+
+    std::vector<std::unique_ptr<Warhead::Actor<CarMessage>>> _cars;
+    std::unique_ptr<Warhead::Actor<DispatcherMessage>> _dispatcher;
+};
+
+#endif
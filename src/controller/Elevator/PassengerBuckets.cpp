@@ -0,0 +1,55 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "PassengerBuckets.h"
+#include <algorithm>
+
+void PassengerBuckets::Resize(uint32 floorCount)
+{
+    _head.assign(floorCount, PASSENGER_ID_NONE);
+    _tail.assign(floorCount, PASSENGER_ID_NONE);
+    _counts.assign(floorCount, 0);
+    _floors.Resize(floorCount);
+    _count = 0;
+}
+
+void PassengerBuckets::Clear()
+{
+    std::fill(_head.begin(), _head.end(), PASSENGER_ID_NONE);
+    std::fill(_tail.begin(), _tail.end(), PASSENGER_ID_NONE);
+    std::fill(_counts.begin(), _counts.end(), 0);
+    _floors.Clear();
+    _count = 0;
+}
+
+void PassengerBuckets::Add(uint32 floorIndex, PassengerId id)
+{
+    _store.SetNext(id, PASSENGER_ID_NONE);
+
+    if (_tail[floorIndex] == PASSENGER_ID_NONE)
+    {
+        _head[floorIndex] = id;
+        _floors.Set(floorIndex);
+    }
+    else
+        _store.SetNext(_tail[floorIndex], id);
+
+    _tail[floorIndex] = id;
+    _counts[floorIndex]++;
+    _count++;
+}
@@ -0,0 +1,129 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_PASSENGER_BUCKETS_H_
+#define WARHEAD_PASSENGER_BUCKETS_H_
+
+#include "FloorSet.h"
+#include "PassengerStore.h"
+#include <utility>
+
+// Passengers grouped by floor. Every floor is FIFO list linked through PassengerStore,
+// so visit of one floor touches only passengers of this floor and never allocates.
+class WH_CTRL_API PassengerBuckets
+{
+public:
+    explicit PassengerBuckets(PassengerStore& store) : _store(store) { }
+    ~PassengerBuckets() = default;
+
+    PassengerBuckets(PassengerBuckets const&) = delete;
+    PassengerBuckets& operator=(PassengerBuckets const&) = delete;
+
+    // Change count of floors. Remove all passengers
+    void Resize(uint32 floorCount);
+
+    // Remove all passengers. Records in store are not released
+    void Clear();
+
+    // Add passenger at end of floor list
+    void Add(uint32 floorIndex, PassengerId id);
+
+    // Remove passengers from start of floor list while pred(id) is true. Call fn(id) for every removed passenger
+    template<class Pred, class Fn>
+    uint32 TakeWhile(uint32 floorIndex, Pred&& pred, Fn&& fn)
+    {
+        uint32 taken{};
+        auto id = _head[floorIndex];
+
+        while (id != PASSENGER_ID_NONE && pred(id))
+        {
+            // Read next before fn, it can link passenger into another list
+            auto next = _store.GetNext(id);
+            _store.SetNext(id, PASSENGER_ID_NONE);
+
+            fn(id);
+
+            id = next;
+            taken++;
+        }
+
+        _head[floorIndex] = id;
+        _counts[floorIndex] -= taken;
+        _count -= taken;
+
+        if (id == PASSENGER_ID_NONE)
+        {
+            _tail[floorIndex] = PASSENGER_ID_NONE;
+            _floors.Reset(floorIndex);
+        }
+
+        return taken;
+    }
+
+    // Remove up to count passengers from start of floor list. Call fn(id) for every removed passenger
+    template<class Fn>
+    inline uint32 Take(uint32 floorIndex, uint32 count, Fn&& fn)
+    {
+        uint32 checked{};
+        return TakeWhile(floorIndex, [&checked, count](PassengerId) { return checked++ < count; }, std::forward<Fn>(fn));
+    }
+
+    // Remove all passengers from floor list. Call fn(id) for every removed passenger
+    template<class Fn>
+    inline uint32 TakeAll(uint32 floorIndex, Fn&& fn) { return Take(floorIndex, _counts[floorIndex], std::forward<Fn>(fn)); }
+
+    // Call fn(id) for every passenger on floor without removing
+    template<class Fn>
+    void ForEach(uint32 floorIndex, Fn&& fn) const
+    {
+        for (auto id = _head[floorIndex]; id != PASSENGER_ID_NONE; id = _store.GetNext(id))
+            fn(id);
+    }
+
+    // Floors with at least one passenger
+    [[nodiscard]] inline FloorSet const& GetFloors() const { return _floors; }
+
+    // Count of passengers on floor
+    [[nodiscard]] inline uint32 GetCount(uint32 floorIndex) const { return _counts[floorIndex]; }
+
+    // Count of passengers on all floors
+    [[nodiscard]] inline std::size_t GetCount() const { return _count; }
+
+    [[nodiscard]] inline bool Empty() const { return !_count; }
+
+private:
+    // Store with passenger records and list links
+    PassengerStore& _store;
+
+    // First passenger on every floor
+    std::vector<PassengerId> _head;
+
+    // Last passenger on every floor
+    std::vector<PassengerId> _tail;
+
+    // Count of passengers on every floor
+    std::vector<uint32> _counts;
+
+    // Floors with at least one passenger
+    FloorSet _floors;
+
+    // Count of passengers on all floors
+    std::size_t _count{};
+};
+
+#endif
@@ -0,0 +1,94 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "PassengerStore.h"
+
+void PassengerStore::Reserve(std::size_t count)
+{
+    _origin.reserve(count);
+    _destination.reserve(count);
+    _arrivalTime.reserve(count);
+    _boardTime.reserve(count);
+    _mass.reserve(count);
+    _journeyOrigin.reserve(count);
+    _finalDestination.reserve(count);
+    _journeyStart.reserve(count);
+    _deck.reserve(count);
+    _next.reserve(count);
+    _freeIds.reserve(count);
+}
+
+void PassengerStore::Clear()
+{
+    _origin.clear();
+    _destination.clear();
+    _arrivalTime.clear();
+    _boardTime.clear();
+    _mass.clear();
+    _journeyOrigin.clear();
+    _finalDestination.clear();
+    _journeyStart.clear();
+    _deck.clear();
+    _next.clear();
+    _freeIds.clear();
+}
+
+PassengerId PassengerStore::Create(Floor origin, Floor destination, Milliseconds arrivalTime, uint16 mass /*= DEFAULT_PASSENGER_MASS*/)
+{
+    if (!_freeIds.empty())
+    {
+        auto id = _freeIds.back();
+        _freeIds.pop_back();
+
+        _origin[id] = origin;
+        _destination[id] = destination;
+        _arrivalTime[id] = arrivalTime;
+        _boardTime[id] = arrivalTime;
+        _mass[id] = mass;
+        _journeyOrigin[id] = origin;
+        _finalDestination[id] = destination;
+        _journeyStart[id] = arrivalTime;
+        _deck[id] = 0;
+        _next[id] = PASSENGER_ID_NONE;
+        return id;
+    }
+
+    auto id = static_cast<PassengerId>(_origin.size());
+
+    _origin.emplace_back(origin);
+    _destination.emplace_back(destination);
+    _arrivalTime.emplace_back(arrivalTime);
+    _boardTime.emplace_back(arrivalTime);
+    _mass.emplace_back(mass);
+    _journeyOrigin.emplace_back(origin);
+    _finalDestination.emplace_back(destination);
+    _journeyStart.emplace_back(arrivalTime);
+    _deck.emplace_back(0);
+    _next.emplace_back(PASSENGER_ID_NONE);
+
+    // Free list never holds more ids than records. Grow it only together with records
+    if (_freeIds.capacity() < _origin.capacity())
+        _freeIds.reserve(_origin.capacity());
+
+    return id;
+}
+
+void PassengerStore::Release(PassengerId id)
+{
+    _freeIds.emplace_back(id);
+}
@@ -0,0 +1,118 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_PASSENGER_STORE_H_
+#define WARHEAD_PASSENGER_STORE_H_
+
+#include "Building.h"
+#include "Duration.h"
+#include <limits>
+#include <vector>
+
+// Index of passenger record in PassengerStore
+using PassengerId = uint32;
+
+// Passenger id used as end of passenger list
+constexpr PassengerId PASSENGER_ID_NONE = std::numeric_limits<PassengerId>::max();
+
+// Mass of passenger if not known, kg
+constexpr uint16 DEFAULT_PASSENGER_MASS = 75;
+
+// Pool of passenger records stored as struct of arrays.
+// Released ids are reused, so after Reserve or warm up no allocations happen.
+class WH_CTRL_API PassengerStore
+{
+public:
+    PassengerStore() = default;
+    ~PassengerStore() = default;
+
+    // Reserve space for count alive passengers
+    void Reserve(std::size_t count);
+
+    // Release all passengers. Keep allocated memory
+    void Clear();
+
+    // Create passenger record. Reuse released id if any
+    PassengerId Create(Floor origin, Floor destination, Milliseconds arrivalTime, uint16 mass = DEFAULT_PASSENGER_MASS);
+
+    // Release passenger record. Id can be reused by next Create
+    void Release(PassengerId id);
+
+    [[nodiscard]] inline Floor GetOrigin(PassengerId id) const { return _origin[id]; }
+    [[nodiscard]] inline Floor GetDestination(PassengerId id) const { return _destination[id]; }
+    [[nodiscard]] inline Milliseconds GetArrivalTime(PassengerId id) const { return _arrivalTime[id]; }
+    [[nodiscard]] inline Milliseconds GetBoardTime(PassengerId id) const { return _boardTime[id]; }
+    [[nodiscard]] inline uint16 GetMass(PassengerId id) const { return _mass[id]; }
+    [[nodiscard]] inline Floor GetJourneyOrigin(PassengerId id) const { return _journeyOrigin[id]; }
+    [[nodiscard]] inline Floor GetFinalDestination(PassengerId id) const { return _finalDestination[id]; }
+    [[nodiscard]] inline Milliseconds GetJourneyStart(PassengerId id) const { return _journeyStart[id]; }
+    [[nodiscard]] inline uint8 GetDeck(PassengerId id) const { return _deck[id]; }
+
+    [[nodiscard]] inline PassengerId GetNext(PassengerId id) const { return _next[id]; }
+
+    inline void SetBoardTime(PassengerId id, Milliseconds boardTime) { _boardTime[id] = boardTime; }
+    inline void SetNext(PassengerId id, PassengerId next) { _next[id] = next; }
+    inline void SetDeck(PassengerId id, uint8 deck) { _deck[id] = deck; }
+
+    // Passenger rides from origin to destination as one leg of longer journey
+    inline void SetJourney(PassengerId id, Floor journeyOrigin, Floor finalDestination, Milliseconds journeyStart)
+    {
+        _journeyOrigin[id] = journeyOrigin;
+        _finalDestination[id] = finalDestination;
+        _journeyStart[id] = journeyStart;
+    }
+
+    // Count of alive passengers
+    [[nodiscard]] inline std::size_t GetCount() const { return _origin.size() - _freeIds.size(); }
+
+    // Count of passengers stored without allocation
+    [[nodiscard]] inline std::size_t GetCapacity() const { return _origin.capacity(); }
+
+private:
+    // Floor where passenger called elevator
+    std::vector<Floor> _origin;
+
+    // Floor where passenger exits elevator
+    std::vector<Floor> _destination;
+
+    // Time when passenger called elevator
+    std::vector<Milliseconds> _arrivalTime;
+
+    // Time when passenger entered elevator
+    std::vector<Milliseconds> _boardTime;
+
+    // Passenger mass in kg
+    std::vector<uint16> _mass;
+
+    // Floor and time of first hall call and last destination of journey with transfers.
+    // Same as origin, arrival time and destination for one car journey
+    std::vector<Floor> _journeyOrigin;
+    std::vector<Floor> _finalDestination;
+    std::vector<Milliseconds> _journeyStart;
+
+    // Deck of double-deck car where passenger rides. 0 - lower deck
+    std::vector<uint8> _deck;
+
+    // Next passenger in same list. Used by PassengerBuckets
+    std::vector<PassengerId> _next;
+
+    // Released ids ready for reuse
+    std::vector<PassengerId> _freeIds;
+};
+
+#endif
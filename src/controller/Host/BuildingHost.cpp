@@ -0,0 +1,96 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "BuildingHost.h"
+#include <utility>
+
+BuildingHost::BuildingHost(std::size_t threadCount /*= 0*/) :
+    _pool(threadCount) { }
+
+std::size_t BuildingHost::AddBuilding(std::size_t carCount, BuildingGeometry const& geometry)
+{
+    auto& building = *_buildings.emplace_back(std::make_unique<HostedBuilding>());
+    building.Group = std::make_unique<ElevatorGroup>(carCount, geometry);
+    return _buildings.size() - 1;
+}
+
+bool BuildingHost::PostPassenger(std::size_t buildingIndex, Floor currentFloor, Floor floorNeed)
+{
+    return _buildings.at(buildingIndex)->Group->PostPassenger(currentFloor, floorNeed);
+}
+
+std::size_t BuildingHost::Update(Milliseconds diff)
+{
+    std::size_t updatedCount{};
+
+    for (std::size_t i{}; i < _buildings.size(); i++)
+    {
+        auto& building = *_buildings[i];
+        building.SkippedTime += diff;
+
+        // Previous update isn't finished. Don't wait slow building, it takes time of this tick later
+        if (building.IsUpdating.load(std::memory_order_acquire))
+            continue;
+
+        if (building.Group->IsIdle())
+            continue;
+
+        building.IsUpdating.store(true, std::memory_order_relaxed);
+
+        // Home worker of building is its index modulo thread count
+        _pool.PostWork(i, [&building, time = std::exchange(building.SkippedTime, 0ms)]()
+        {
+            building.Group->Update(time);
+            building.IsUpdating.store(false, std::memory_order_release);
+        });
+
+        updatedCount++;
+    }
+
+    return updatedCount;
+}
+
+void BuildingHost::Wait()
+{
+    _pool.Wait();
+}
+
+std::size_t BuildingHost::GetDeliveredCount() const
+{
+    std::size_t count{};
+
+    for (auto const& building : _buildings)
+        count += building->Group->GetDeliveredCount();
+
+    return count;
+}
+
+PassengerStats BuildingHost::GetStats() const
+{
+    PassengerStats stats;
+
+    if (_buildings.empty())
+        return stats;
+
+    stats.Resize(_buildings.front()->Group->GetGeometry().GetFloorCount());
+
+    for (auto const& building : _buildings)
+        stats.Merge(building->Group->GetStats());
+
+    return stats;
+}
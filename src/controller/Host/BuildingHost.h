@@ -0,0 +1,88 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_BUILDING_HOST_H_
+#define WARHEAD_BUILDING_HOST_H_
+
+#include "ElevatorGroup.h"
+#include "WorkStealingPool.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Many independent buildings controlled by one process. Busy buildings update in parallel on work-stealing pool,
+// every building on its home worker unless other worker is free first. Idle buildings are skipped, so CPU use follows load, not building count.
+// Update doesn't wait buildings. Building still updating from previous tick gets time of skipped ticks with its next update, so slow building doesn't delay others
+class WH_CTRL_API BuildingHost
+{
+public:
+    // 0 - use hardware concurrency
+    explicit BuildingHost(std::size_t threadCount = 0);
+    ~BuildingHost() = default;
+
+    BuildingHost(BuildingHost const&) = delete;
+    BuildingHost& operator=(BuildingHost const&) = delete;
+
+    // Add building with own group of cars. Returns index of building. Not while Update runs
+    std::size_t AddBuilding(std::size_t carCount, BuildingGeometry const& geometry);
+
+    // Get cars of building
+    [[nodiscard]] inline ElevatorGroup& GetBuilding(std::size_t buildingIndex) const { return *_buildings.at(buildingIndex)->Group; }
+
+    [[nodiscard]] inline std::size_t GetBuildingCount() const { return _buildings.size(); }
+
+    // Post hall call in building from any thread without lock. Returns false if ingress of building is full
+    bool PostPassenger(std::size_t buildingIndex, Floor currentFloor, Floor floorNeed);
+
+    // Start update of busy buildings in parallel. Idle building and building still updating get skipped time with next update.
+    // Returns count of started building updates
+    std::size_t Update(Milliseconds diff);
+
+    // Block until all started building updates are done. Call before reading buildings
+    void Wait();
+
+    // Get count of passengers delivered in all buildings
+    [[nodiscard]] std::size_t GetDeliveredCount() const;
+
+    // Get passenger time histograms of all buildings. Buildings must have same geometry
+    [[nodiscard]] PassengerStats GetStats() const;
+
+    // Count of building updates done by other worker than home one
+    [[nodiscard]] inline uint64 GetStealCount() const { return _pool.GetStealCount(); }
+
+    [[nodiscard]] inline std::size_t GetThreadCount() const { return _pool.GetThreadCount(); }
+
+private:
+    struct HostedBuilding
+    {
+        std::unique_ptr<ElevatorGroup> Group;
+
+        // Time not passed to idle or busy group. Used only by Update thread
+        Milliseconds SkippedTime{};
+
+        // Update of group is posted and not finished yet
+        std::atomic<bool> IsUpdating{};
+    };
+
+    std::vector<std::unique_ptr<HostedBuilding>> _buildings;
+
+    // Destroyed before buildings
+    Warhead::WorkStealingPool _pool;
+};
+
+#endif
@@ -0,0 +1,152 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MotionProfile.h"
+#include "Config.h"
+#include "Log.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr double GRAVITY = 9.81;
+
+    // Iterations of peak speed search for short trips. Error is below 1e-9 of rated speed
+    constexpr uint32 PEAK_SPEED_ITERATIONS = 32;
+
+    // Time to reach speed from rest with jerk and acceleration limits, s
+    double GetAccelerationTime(double speed, MotionProfile const& profile)
+    {
+        // Acceleration limit is reached only if speed is high enough
+        if (speed >= profile.Acceleration * profile.Acceleration / profile.Jerk)
+            return speed / profile.Acceleration + profile.Acceleration / profile.Jerk;
+
+        return 2.0 * std::sqrt(speed / profile.Jerk);
+    }
+
+    // Distance to reach speed from rest. Profile is symmetric, so average speed is half of final speed
+    double GetAccelerationDistance(double speed, MotionProfile const& profile)
+    {
+        return speed * GetAccelerationTime(speed, profile) / 2.0;
+    }
+}
+
+/*static*/ MotionProfile MotionProfile::LoadFromConfig()
+{
+    MotionProfile profile;
+    MotionProfile const defaultProfile;
+
+    auto getPositive = [](std::string const& key, double defaultValue)
+    {
+        auto value = static_cast<double>(sConfigMgr->GetOption<float>(key, static_cast<float>(defaultValue)));
+        if (value > 0.0)
+            return value;
+
+        LOG_ERROR("building", "> Motion: {} must be positive. Use default {}", key, defaultValue);
+        return defaultValue;
+    };
+
+    profile.MaxSpeed = getPositive("Motion.MaxSpeed", defaultProfile.MaxSpeed);
+    profile.Acceleration = getPositive("Motion.Acceleration", defaultProfile.Acceleration);
+    profile.Jerk = getPositive("Motion.Jerk", defaultProfile.Jerk);
+    profile.FloorHeight = getPositive("Motion.FloorHeight", defaultProfile.FloorHeight);
+    profile.DoorTime = Milliseconds(sConfigMgr->GetOption<uint32>("Motion.DoorTime", static_cast<uint32>(defaultProfile.DoorTime.count())));
+    profile.DwellTime = Milliseconds(sConfigMgr->GetOption<uint32>("Motion.DwellTime", static_cast<uint32>(defaultProfile.DwellTime.count())));
+    profile.CarMass = sConfigMgr->GetOption<uint32>("Motion.CarMass", defaultProfile.CarMass);
+    profile.CounterweightMass = sConfigMgr->GetOption<uint32>("Motion.CounterweightMass", defaultProfile.CounterweightMass);
+    profile.DriveEfficiency = std::clamp(getPositive("Motion.DriveEfficiency", defaultProfile.DriveEfficiency), 0.01, 1.0);
+
+    LOG_INFO("building", "> Motion: Speed {} m/s, acceleration {} m/s^2, jerk {} m/s^3, floor height {} m",
+        profile.MaxSpeed, profile.Acceleration, profile.Jerk, profile.FloorHeight);
+    return profile;
+}
+
+FlightTimeTable::FlightTimeTable(BuildingGeometry const& geometry, MotionProfile const& profile) :
+    _profile(profile)
+{
+    auto const floorCount = geometry.GetFloorCount();
+
+    _flightTimes.resize(floorCount);
+    _peakSpeeds.resize(floorCount);
+
+    auto const fullSpeedDistance = 2.0 * GetAccelerationDistance(profile.MaxSpeed, profile);
+
+    for (uint32 floors = 1; floors < floorCount; floors++)
+    {
+        auto const distance = floors * profile.FloorHeight;
+        double seconds{};
+
+        if (distance >= fullSpeedDistance)
+        {
+            _peakSpeeds[floors] = profile.MaxSpeed;
+            seconds = 2.0 * GetAccelerationTime(profile.MaxSpeed, profile) + (distance - fullSpeedDistance) / profile.MaxSpeed;
+        }
+        else
+        {
+            // Car brakes before rated speed. Distance grows with peak speed, so bisect it
+            double low{}, high{ profile.MaxSpeed };
+
+            for (uint32 i{}; i < PEAK_SPEED_ITERATIONS; i++)
+            {
+                auto middle = (low + high) / 2.0;
+                (2.0 * GetAccelerationDistance(middle, profile) < distance ? low : high) = middle;
+            }
+
+            _peakSpeeds[floors] = high;
+            seconds = 2.0 * GetAccelerationTime(high, profile);
+        }
+
+        _flightTimes[floors] = Milliseconds(static_cast<int64>(std::ceil(seconds * 1000.0)));
+    }
+}
+
+double FlightTimeTable::GetEnergy(Floor from, Floor to, uint32 load) const
+{
+    auto const distance = GetDistance(from, to);
+    if (!distance)
+        return 0.0;
+
+    // Car side heavier than counterweight needs drive going up, lighter car needs it going down
+    auto const imbalance = static_cast<double>(_profile.CarMass) + load - _profile.CounterweightMass;
+    auto const height = (to - from) * _profile.FloorHeight;
+    auto const potential = std::max(0.0, imbalance * GRAVITY * height);
+
+    // Kinetic energy of all moving masses is lost in braking
+    auto const movingMass = static_cast<double>(_profile.CarMass) + _profile.CounterweightMass + load;
+    auto const kinetic = movingMass * _peakSpeeds[distance] * _peakSpeeds[distance] / 2.0;
+
+    return (potential + kinetic) / _profile.DriveEfficiency;
+}
+
+EtaTiming FlightTimeTable::GetEtaTiming() const
+{
+    EtaTiming timing;
+    timing.StopTime = GetStopTime();
+
+    auto const maxDistance = _flightTimes.size() - 1;
+    if (maxDistance < 2)
+    {
+        timing.FloorTravelTime = maxDistance ? _flightTimes[1] : timing.FloorTravelTime;
+        return timing;
+    }
+
+    // Slope of flight time is travel of one floor at speed. Rest of one floor flight is acceleration and braking
+    timing.FloorTravelTime = (_flightTimes[maxDistance] - _flightTimes[1]) / static_cast<int64>(maxDistance - 1);
+    timing.StopTime += std::max(0ms, _flightTimes[1] - timing.FloorTravelTime);
+    return timing;
+}
@@ -0,0 +1,96 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_MOTION_PROFILE_H_
+#define WARHEAD_MOTION_PROFILE_H_
+
+#include "Building.h"
+#include "EtaTable.h"
+#include <vector>
+
+// Kinematic limits of car drive, door times and masses for energy estimate
+struct WH_CTRL_API MotionProfile
+{
+    // Load motion options from config
+    static MotionProfile LoadFromConfig();
+
+    // Rated car speed, m/s
+    double MaxSpeed{ 2.5 };
+
+    // Max acceleration and deceleration, m/s^2
+    double Acceleration{ 1.0 };
+
+    // Max change of acceleration, m/s^3
+    double Jerk{ 1.5 };
+
+    // Distance between adjacent floors, m
+    double FloorHeight{ 3.5 };
+
+    // Time to open or close doors
+    Milliseconds DoorTime{ 2s };
+
+    // Time with open doors for passengers exit and enter
+    Milliseconds DwellTime{ 3s };
+
+    // Mass of empty car, kg
+    uint32 CarMass{ 1000 };
+
+    // Mass of counterweight, kg. Usually car mass plus half of rated load
+    uint32 CounterweightMass{ 1500 };
+
+    // Share of drive energy used for motion
+    double DriveEfficiency{ 0.8 };
+};
+
+// Floor to floor flight times and drive energy of building, precomputed for every distance in floors.
+// Jerk limited S-curve: jerk up to acceleration, cruise at rated speed, symmetric braking.
+// Short trips never reach rated speed, their peak speed is found once at build. Lookup is O(1)
+class WH_CTRL_API FlightTimeTable
+{
+public:
+    FlightTimeTable(BuildingGeometry const& geometry, MotionProfile const& profile);
+    ~FlightTimeTable() = default;
+
+    // Time from start of motion to stop on target floor. Doors are closed whole time
+    [[nodiscard]] inline Milliseconds GetFlightTime(Floor from, Floor to) const { return _flightTimes[GetDistance(from, to)]; }
+
+    // Time of one stop: doors opening, dwell and doors closing
+    [[nodiscard]] inline Milliseconds GetStopTime() const { return _profile.DoorTime * 2 + _profile.DwellTime; }
+
+    // Drive energy of trip with load in car, J. Lifting heavier side costs potential energy, braking loses kinetic energy
+    [[nodiscard]] double GetEnergy(Floor from, Floor to, uint32 load) const;
+
+    // Linear time model with same flight time for long trips and stop time including acceleration and braking
+    [[nodiscard]] EtaTiming GetEtaTiming() const;
+
+    [[nodiscard]] inline MotionProfile const& GetProfile() const { return _profile; }
+
+private:
+    [[nodiscard]] inline std::size_t GetDistance(Floor from, Floor to) const
+    {
+        return static_cast<std::size_t>(from > to ? from - to : to - from);
+    }
+
+    MotionProfile _profile;
+
+    // Flight time and peak speed by distance in floors
+    std::vector<Milliseconds> _flightTimes;
+    std::vector<double> _peakSpeeds;
+};
+
+#endif
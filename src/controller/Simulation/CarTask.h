@@ -0,0 +1,81 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_CAR_TASK_H_
+#define WARHEAD_CAR_TASK_H_
+
+#include "Define.h"
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+// Control sequence of one car as coroutine. Starts at once and runs until first suspension, then is resumed only by scheduler.
+// Suspended car is one coroutine frame, no thread and no stack
+class CarTask
+{
+public:
+    struct promise_type
+    {
+        CarTask get_return_object() { return CarTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() { }
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    CarTask() = default;
+    ~CarTask() { Destroy(); }
+
+    CarTask(CarTask const&) = delete;
+    CarTask& operator=(CarTask const&) = delete;
+
+    CarTask(CarTask&& other) noexcept : _handle(std::exchange(other._handle, {})) { }
+
+    CarTask& operator=(CarTask&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Destroy();
+            _handle = std::exchange(other._handle, {});
+        }
+
+        return *this;
+    }
+
+    // Continue car sequence until next suspension
+    inline void Resume() const
+    {
+        if (_handle && !_handle.done())
+            _handle.resume();
+    }
+
+private:
+    explicit CarTask(std::coroutine_handle<promise_type> handle) : _handle(handle) { }
+
+    void Destroy()
+    {
+        if (_handle)
+            _handle.destroy();
+
+        _handle = {};
+    }
+
+    std::coroutine_handle<promise_type> _handle;
+};
+
+#endif
@@ -0,0 +1,425 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Simulation.h"
+#include "Config.h"
+#include "Log.h"
+#include "Random.h"
+#include "StopWatch.h"
+#include <algorithm>
+#include <random>
+
+namespace
+{
+    // Count of arrivals generated by traffic model at once
+    constexpr std::size_t ARRIVAL_BATCH_SIZE = 1024;
+
+    // Reallocation search of one building if config has no iteration limit or chain count
+    constexpr uint64 REALLOCATION_ITERATIONS = 4096;
+    constexpr std::size_t REALLOCATION_CHAIN_COUNT = 2;
+}
+
+/*static*/ SimulationConfig SimulationConfig::LoadFromConfig()
+{
+    SimulationConfig config;
+    SimulationConfig const defaultConfig;
+
+    config.Geometry = BuildingGeometry::LoadFromConfig();
+    config.CarCount = std::clamp<uint32>(sConfigMgr->GetOption<uint32>("Simulation.CarCount", defaultConfig.CarCount), 1, ElevatorGroup::MAX_CAR_COUNT);
+    config.BuildingCount = std::max<uint32>(1, sConfigMgr->GetOption<uint32>("Simulation.BuildingCount", defaultConfig.BuildingCount));
+    config.Banks = ElevatorBank::LoadFromConfig(config.Geometry);
+
+    // Banks define cars of group
+    if (!config.Banks.empty())
+    {
+        uint32 carCount{};
+        for (auto const& bank : config.Banks)
+            carCount += bank.CarCount;
+
+        if (carCount <= ElevatorGroup::MAX_CAR_COUNT)
+            config.CarCount = carCount;
+        else
+        {
+            LOG_ERROR("simulation", "> Simulation: Banks have {} cars, group can't have more than {}. All cars serve all floors", carCount, ElevatorGroup::MAX_CAR_COUNT);
+            config.Banks.clear();
+        }
+    }
+    config.Capacity = CarCapacity::LoadFromConfig();
+    config.DoubleDeck = sConfigMgr->GetOption<bool>("Building.DoubleDeck", false);
+    config.Duration = Seconds(sConfigMgr->GetOption<uint32>("Simulation.Duration", static_cast<uint32>(std::chrono::duration_cast<Seconds>(defaultConfig.Duration).count())));
+    config.Motion = MotionProfile::LoadFromConfig();
+    config.Traffic = TrafficConfig::LoadFromConfig();
+    config.ReplayFile = sConfigMgr->GetOption<std::string>("Trace.ReplayFile", "");
+    config.Seed = sConfigMgr->GetOption<uint64>("Simulation.Seed", defaultConfig.Seed);
+    config.Policy = DispatchPolicyRegistry::LoadFromConfig();
+    config.AssignmentMode = sConfigMgr->GetOption<bool>("Dispatch.DestinationMode", false) ? GroupAssignmentMode::Destination : GroupAssignmentMode::Collective;
+    config.CostFunction = sConfigMgr->GetOption<bool>("Dispatch.EtaCost", false) ? GroupCostFunction::Eta : GroupCostFunction::Distance;
+    config.Reallocation = CallAllocatorConfig::LoadFromConfig();
+    config.Parking = sConfigMgr->GetOption<bool>("Dispatch.Parking.Enable", false);
+    config.Demand = DemandModelConfig::LoadFromConfig();
+    return config;
+}
+
+double SimulationReport::GetSpeedRatio() const
+{
+    if (RealTime == 0us)
+        return 0.0;
+
+    return static_cast<double>(std::chrono::duration_cast<Microseconds>(SimulatedTime).count()) / static_cast<double>(RealTime.count());
+}
+
+Simulation::SimulatedBuilding::SimulatedBuilding(SimulationConfig const& config, uint64 seed) :
+    Group(config.CarCount, config.Geometry), Demand(config.Geometry, config.Demand), Traffic(config.Geometry, config.Traffic, seed),
+    Arrivals(ARRIVAL_BATCH_SIZE), NextArrival(ARRIVAL_BATCH_SIZE)
+{
+    if (!config.ReplayFile.empty())
+        Replay.Open(config.ReplayFile);
+}
+
+Simulation::Simulation(SimulationConfig const& config) :
+    _config(config), _flightTimes(config.Geometry, config.Motion)
+{
+    _config.BuildingCount = std::max<uint32>(1, _config.BuildingCount);
+
+    auto const timing = _flightTimes.GetEtaTiming();
+    auto const seed = _config.Seed ? _config.Seed : std::random_device{}();
+
+    // Planner uses simulated car times
+    if (auto planner = std::get_if<BranchAndBoundPolicy>(&_config.Policy))
+        planner->Timing = timing;
+
+    // Search runs inline with fixed work, so seeded run is same on any machine and buildings start no workers
+    _config.Reallocation.Seed = _config.Seed;
+    _config.Reallocation.IsInline = true;
+
+    if (!_config.Reallocation.Iterations)
+        _config.Reallocation.Iterations = REALLOCATION_ITERATIONS;
+
+    if (!_config.Reallocation.ChainCount)
+        _config.Reallocation.ChainCount = REALLOCATION_CHAIN_COUNT;
+
+    _buildings.reserve(_config.BuildingCount);
+
+    for (uint32 buildingIndex{}; buildingIndex < _config.BuildingCount; buildingIndex++)
+    {
+        // First building uses seed of config, so one building run doesn't depend on building count
+        auto& building = *_buildings.emplace_back(std::make_unique<SimulatedBuilding>(_config, buildingIndex ? Warhead::GetStreamSeed(seed, buildingIndex) : seed));
+        auto& group = building.Group;
+
+        group.SetBanks(_config.Banks);
+        group.SetDispatchPolicy(_config.Policy);
+        group.SetCapacity(_config.Capacity);
+        group.SetDoubleDeck(_config.DoubleDeck);
+        group.SetAssignmentMode(_config.AssignmentMode);
+        group.SetCostFunction(_config.CostFunction);
+        group.SetEtaTiming(timing);
+        group.SetReallocation(_config.Reallocation);
+
+        if (_config.Parking)
+            group.SetDemandModel(&building.Demand);
+    }
+
+    auto const carCount = _config.BuildingCount * _config.CarCount;
+    _carStates.resize(carCount, CarState::Idle);
+    _carTargets.resize(carCount, _config.Geometry.LobbyFloor);
+
+    if (_config.Parking)
+        _parkedFloors.reserve(_config.CarCount);
+}
+
+SimulationReport Simulation::Run()
+{
+    StopWatch sw;
+
+    for (uint32 buildingIndex{}; buildingIndex < _buildings.size(); buildingIndex++)
+    {
+        auto& building = *_buildings[buildingIndex];
+        if ((building.Replay.IsOpen() || building.Traffic.IsEnabled()) && FetchArrival(building))
+            Schedule(building.Arrival.Time, SimulationEventType::PassengerArrival, buildingIndex);
+    }
+
+    for (uint32 buildingIndex{}; buildingIndex < _buildings.size(); buildingIndex++)
+        if (_buildings[buildingIndex]->Group.IsReallocationEnabled())
+            Schedule(_config.Reallocation.Interval, SimulationEventType::Reallocation, buildingIndex);
+
+    // Select policy once. Event loop is instantiated for every policy
+    std::visit([this](auto const& policy) { ProcessEvents(policy); }, _config.Policy);
+
+    _now = _config.Duration;
+
+    SimulationReport report;
+    report.SimulatedTime = _now;
+    report.RealTime = sw.Elapsed();
+    report.EventCount = _eventCount;
+    report.Energy = _energy / 3.6e6;
+
+    for (auto const& building : _buildings)
+    {
+        report.ArrivedCount += building->ArrivedCount;
+        report.DeliveredCount += building->Group.GetDeliveredCount();
+        report.ReallocatedCount += building->Group.GetReallocatedCount();
+    }
+
+    return report;
+}
+
+PassengerStats Simulation::GetStats() const
+{
+    PassengerStats stats;
+    stats.Resize(_config.Geometry.GetFloorCount());
+
+    for (auto const& building : _buildings)
+        stats.Merge(building->Group.GetStats());
+
+    return stats;
+}
+
+void Simulation::Schedule(Milliseconds time, SimulationEventType type, uint32 buildingIndex, uint32 carIndex /*= 0*/)
+{
+    _events.push({ time, _sequence++, type, buildingIndex, carIndex });
+}
+
+template<DispatchPolicy Policy>
+void Simulation::ProcessEvents(Policy const& policy)
+{
+    // Every car is suspended coroutine between events
+    _carTasks.clear();
+    _carTasks.reserve(_carStates.size());
+
+    for (uint32 carIndex{}; carIndex < _carStates.size(); carIndex++)
+        _carTasks.emplace_back(RunCar(carIndex, policy));
+
+    while (!_events.empty() && _events.top().Time <= _config.Duration)
+    {
+        auto event = _events.top();
+        _events.pop();
+
+        _now = event.Time;
+        ProcessEvent(event);
+        _eventCount++;
+    }
+}
+
+void Simulation::ProcessEvent(SimulationEvent const& event)
+{
+    switch (event.Type)
+    {
+        case SimulationEventType::PassengerArrival:
+            OnPassengerArrival(event.BuildingIndex);
+            break;
+        case SimulationEventType::CarResume:
+            _carTasks[event.CarIndex].Resume();
+            break;
+        case SimulationEventType::Reallocation:
+            OnReallocation(event.BuildingIndex);
+            break;
+        default:
+            break;
+    }
+}
+
+template<DispatchPolicy Policy>
+CarTask Simulation::RunCar(uint32 carIndex, Policy const& policy)
+{
+    auto car = GetCar(carIndex);
+
+    // Car waits first hall call on start floor
+    _carStates[carIndex] = CarState::Idle;
+    co_await std::suspend_always{};
+
+    for (;;)
+    {
+        if (!car->HasPassengers())
+        {
+            if (!_config.Parking || !ParkCar(carIndex))
+            {
+                _carStates[carIndex] = CarState::Idle;
+                co_await std::suspend_always{};
+                continue;
+            }
+
+            auto parkingFloor = _carTargets[carIndex];
+            co_await Sleep(carIndex, StartTravel(carIndex, car->GetCurrentFloor(), parkingFloor));
+            car->MoveTo(parkingFloor);
+
+            // Parked car waits with closed doors
+            if (!car->HasPassengers())
+            {
+                _carStates[carIndex] = CarState::Idle;
+                co_await std::suspend_always{};
+            }
+
+            continue;
+        }
+
+        auto currentFloor = car->GetCurrentFloor();
+        auto nextFloor = car->GetNextFloor(policy);
+
+        // Passengers on other floor. Otherwise open doors again
+        if (nextFloor != currentFloor)
+        {
+            _carStates[carIndex] = CarState::Moving;
+            _carTargets[carIndex] = nextFloor;
+
+            co_await Sleep(carIndex, StartTravel(carIndex, currentFloor, nextFloor));
+            car->MoveTo(nextFloor);
+        }
+
+        _carStates[carIndex] = CarState::Stopped;
+
+        co_await Sleep(carIndex, _config.Motion.DoorTime);
+        OnDoorOpened(carIndex);
+
+        // Dwell and close doors. Then car selects next floor
+        co_await Sleep(carIndex, _config.Motion.DwellTime + _config.Motion.DoorTime);
+    }
+}
+
+std::suspend_always Simulation::Sleep(uint32 carIndex, Milliseconds duration)
+{
+    Schedule(_now + duration, SimulationEventType::CarResume, GetBuildingIndex(carIndex), carIndex);
+    return {};
+}
+
+void Simulation::WakeUpCar(uint32 carIndex)
+{
+    if (_carStates[carIndex] == CarState::Idle)
+        _carTasks[carIndex].Resume();
+}
+
+void Simulation::OnPassengerArrival(uint32 buildingIndex)
+{
+    auto const& geometry = _config.Geometry;
+    auto& building = *_buildings[buildingIndex];
+    auto const& arrival = building.Arrival;
+
+    // Replayed trace can be recorded in other building
+    if (geometry.IsValidFloor(arrival.Origin) && geometry.IsValidFloor(arrival.Destination))
+    {
+        building.Group.SetClock(_now);
+
+        auto carIndex = building.Group.AddPassenger(arrival.Origin, arrival.Destination);
+        if (carIndex != ElevatorGroup::CAR_NONE)
+        {
+            building.ArrivedCount++;
+            WakeUpCar(buildingIndex * _config.CarCount + static_cast<uint32>(carIndex));
+        }
+    }
+
+    if (FetchArrival(building))
+        Schedule(building.Arrival.Time, SimulationEventType::PassengerArrival, buildingIndex);
+}
+
+void Simulation::OnReallocation(uint32 buildingIndex)
+{
+    auto& group = _buildings[buildingIndex]->Group;
+
+    // Plan of search started on previous tick. Real controller also applies plan on later tick
+    if (group.WaitReallocation())
+        WakeUpIdleCars(buildingIndex);
+
+    group.StartReallocation();
+    Schedule(_now + _config.Reallocation.Interval, SimulationEventType::Reallocation, buildingIndex);
+}
+
+void Simulation::OnDoorOpened(uint32 carIndex)
+{
+    auto& group = GetCarBuilding(carIndex).Group;
+    auto groupCarIndex = carIndex % _config.CarCount;
+
+    auto car = group.GetCar(groupCarIndex);
+    car->SetClock(_now);
+    car->ProcessStop();
+
+    bool isReassigned = car->IsFull() && group.ReassignHallCalls(groupCarIndex);
+
+    // Next car of transfer passenger starts wait from now
+    if (group.ProcessTransfers(groupCarIndex))
+        isReassigned = true;
+
+    if (isReassigned)
+        WakeUpIdleCars(GetBuildingIndex(carIndex));
+}
+
+void Simulation::WakeUpIdleCars(uint32 buildingIndex)
+{
+    auto const firstCar = buildingIndex * _config.CarCount;
+
+    for (uint32 carIndex = firstCar; carIndex < firstCar + _config.CarCount; carIndex++)
+        WakeUpCar(carIndex);
+}
+
+bool Simulation::ParkCar(uint32 carIndex)
+{
+    auto& building = GetCarBuilding(carIndex);
+    auto const firstCar = GetBuildingIndex(carIndex) * _config.CarCount;
+    auto const bankIndex = building.Group.GetBankIndex(carIndex - firstCar);
+
+    _parkedFloors.clear();
+
+    for (uint32 i = firstCar; i < firstCar + _config.CarCount; i++)
+    {
+        // Cars of other banks don't cover calls of this car
+        if (i == carIndex || building.Group.GetBankIndex(i - firstCar) != bankIndex)
+            continue;
+
+        if (_carStates[i] == CarState::Idle)
+            _parkedFloors.emplace_back(building.Group.GetCar(i - firstCar)->GetCurrentFloor());
+        else if (_carStates[i] == CarState::Parking)
+            _parkedFloors.emplace_back(_carTargets[i]);
+    }
+
+    auto car = building.Group.GetCar(carIndex - firstCar);
+    auto currentFloor = car->GetCurrentFloor();
+    auto parkingFloor = car->GetStopFloor(building.Demand.GetParkingFloor(_now, currentFloor, _parkedFloors, &car->GetServedFloors()));
+
+    if (parkingFloor == currentFloor)
+        return false;
+
+    _carStates[carIndex] = CarState::Parking;
+    _carTargets[carIndex] = parkingFloor;
+    return true;
+}
+
+Milliseconds Simulation::StartTravel(uint32 carIndex, Floor from, Floor to)
+{
+    _energy += _flightTimes.GetEnergy(from, to, GetCar(carIndex)->GetLoad());
+    return _flightTimes.GetFlightTime(from, to);
+}
+
+/*static*/ bool Simulation::FetchArrival(SimulatedBuilding& building)
+{
+    if (building.NextArrival == building.Arrivals.size())
+    {
+        if (building.Replay.IsOpen())
+        {
+            building.Arrivals.resize(ARRIVAL_BATCH_SIZE);
+            building.Arrivals.resize(building.Replay.Read(building.Arrivals));
+
+            if (building.Arrivals.empty())
+                return false;
+        }
+        else
+            building.Traffic.Generate(building.Arrivals);
+
+        building.NextArrival = 0;
+    }
+
+    building.Arrival = building.Arrivals[building.NextArrival++];
+    return true;
+}
@@ -0,0 +1,274 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_SIMULATION_H_
+#define WARHEAD_SIMULATION_H_
+
+#include "CarTask.h"
+#include "DemandModel.h"
+#include "ElevatorGroup.h"
+#include "MotionProfile.h"
+#include "PassengerTrace.h"
+#include "TrafficModel.h"
+#include <memory>
+#include <queue>
+#include <vector>
+
+// Options of event driven simulation
+struct WH_CTRL_API SimulationConfig
+{
+    // Load simulation options from config
+    static SimulationConfig LoadFromConfig();
+
+    // Floors of simulated building
+    BuildingGeometry Geometry;
+
+    // Count of cars in group
+    uint32 CarCount{ 1 };
+
+    // Count of same buildings driven by one event queue. Building traffic uses seed derived from Seed and building index
+    uint32 BuildingCount{ 1 };
+
+    // Zoned banks of group. Car counts of banks sum to car count. Empty - all cars serve all floors
+    std::vector<ElevatorBank> Banks;
+
+    // Rated load of every car deck
+    CarCapacity Capacity;
+
+    // Cars have two decks serving adjacent floors on same stop
+    bool DoubleDeck{};
+
+    // Simulated time
+    Milliseconds Duration{ 24h };
+
+    // Car drive, doors and masses. Travel times come from flight time table of profile
+    MotionProfile Motion;
+
+    // Passenger traffic
+    TrafficConfig Traffic;
+
+    // Binary passenger trace to replay instead of traffic model. Empty - not used
+    std::string ReplayFile;
+
+    // Seed for random generator. 0 - random seed
+    uint64 Seed{};
+
+    // Policy selecting next floor of cars
+    AnyDispatchPolicy Policy;
+
+    // How hall calls are assigned to cars
+    GroupAssignmentMode AssignmentMode{ GroupAssignmentMode::Collective };
+
+    // Cost of assigning hall call to car
+    GroupCostFunction CostFunction{ GroupCostFunction::Distance };
+
+    // Periodic reallocation of hall calls between cars
+    CallAllocatorConfig Reallocation;
+
+    // Move idle cars to floors of likely next hall calls
+    bool Parking{};
+
+    // Learned demand used for parking
+    DemandModelConfig Demand;
+};
+
+// Result of simulation run
+struct WH_CTRL_API SimulationReport
+{
+    // Simulated-to-real time ratio
+    [[nodiscard]] double GetSpeedRatio() const;
+
+    Milliseconds SimulatedTime{};
+    Microseconds RealTime{};
+    uint64 EventCount{};
+    uint64 ArrivedCount{};
+    uint64 DeliveredCount{};
+    uint64 ReallocatedCount{};
+
+    // Drive energy of all cars, kWh
+    double Energy{};
+};
+
+// Simulation event types
+enum class SimulationEventType : uint8
+{
+    PassengerArrival,   // New passenger called elevator
+    CarResume,          // Travel, doors or dwell of car finished. Car control coroutine continues
+    Reallocation        // Reallocation tick. Apply plan of previous search and start next one
+};
+
+// Timestamped event in simulation queue
+struct SimulationEvent
+{
+    Milliseconds Time{};
+    uint64 Sequence{};
+    SimulationEventType Type{};
+    uint32 BuildingIndex{};
+
+    // Car of resumed coroutine. Cars of all buildings are numbered in one sequence
+    uint32 CarIndex{};
+
+    // Earlier time first, same time in schedule order
+    friend bool operator>(SimulationEvent const& left, SimulationEvent const& right)
+    {
+        return left.Time != right.Time ? left.Time > right.Time : left.Sequence > right.Sequence;
+    }
+};
+
+// Discrete event simulation of elevator groups in virtual time.
+// One event queue resumes car coroutines of all buildings, so car count is not limited by group size
+class WH_CTRL_API Simulation
+{
+public:
+    explicit Simulation(SimulationConfig const& config);
+    ~Simulation() = default;
+
+    Simulation(Simulation const&) = delete;
+    Simulation& operator=(Simulation const&) = delete;
+
+    // Run simulation as fast as possible until config duration
+    SimulationReport Run();
+
+    // Get elevator group of simulated building
+    [[nodiscard]] inline ElevatorGroup& GetGroup(uint32 buildingIndex = 0) { return _buildings[buildingIndex]->Group; }
+
+    [[nodiscard]] inline uint32 GetBuildingCount() const { return static_cast<uint32>(_buildings.size()); }
+
+    // Passenger stats of all buildings
+    [[nodiscard]] PassengerStats GetStats() const;
+
+    // Get current virtual time
+    [[nodiscard]] inline Milliseconds GetTime() const { return _now; }
+
+private:
+    // Car state between events
+    enum class CarState : uint8
+    {
+        Idle,       // No passengers. Car waits new hall call
+        Moving,     // Car travels to target floor
+        Parking,    // Idle car travels to parking floor
+        Stopped     // Car stays on floor with doors opening, open or closing
+    };
+
+    // Group, traffic and demand of one building
+    struct SimulatedBuilding
+    {
+        SimulatedBuilding(SimulationConfig const& config, uint64 seed);
+
+        ElevatorGroup Group;
+
+        // Hall call demand learned from arrivals
+        DemandModel Demand;
+
+        // Generator of passengers
+        TrafficModel Traffic;
+
+        // Recorded passengers. Used instead of traffic model if open
+        PassengerTraceReader Replay;
+
+        // Arrivals generated in advance
+        std::vector<TrafficArrival> Arrivals;
+        std::size_t NextArrival{};
+
+        // Arrival of next passenger event
+        TrafficArrival Arrival;
+
+        uint64 ArrivedCount{};
+    };
+
+    // Add event in queue
+    void Schedule(Milliseconds time, SimulationEventType type, uint32 buildingIndex, uint32 carIndex = 0);
+
+    [[nodiscard]] inline uint32 GetBuildingIndex(uint32 carIndex) const { return carIndex / _config.CarCount; }
+    [[nodiscard]] inline SimulatedBuilding& GetCarBuilding(uint32 carIndex) { return *_buildings[GetBuildingIndex(carIndex)]; }
+    [[nodiscard]] inline Elevator* GetCar(uint32 carIndex) { return GetCarBuilding(carIndex).Group.GetCar(carIndex % _config.CarCount); }
+
+    // Start car coroutines and process events until config duration
+    template<DispatchPolicy Policy>
+    void ProcessEvents(Policy const& policy);
+
+    // Process one event
+    void ProcessEvent(SimulationEvent const& event);
+
+    // Control sequence of car: wait hall call, travel, arrive, open doors, dwell, close, depart. Suspends in virtual time only
+    template<DispatchPolicy Policy>
+    CarTask RunCar(uint32 carIndex, Policy const& policy);
+
+    // Schedule resume of car coroutine after duration. Use as co_await Sleep(...)
+    std::suspend_always Sleep(uint32 carIndex, Milliseconds duration);
+
+    // Resume idle car coroutine. Car selects next floor or parks
+    void WakeUpCar(uint32 carIndex);
+
+    // Add new passenger and schedule next arrival
+    void OnPassengerArrival(uint32 buildingIndex);
+
+    // Move hall calls by plan of previous search, wake up idle cars and start next search
+    void OnReallocation(uint32 buildingIndex);
+
+    // Exit and board passengers. Passengers left by full car and transferring passengers call other cars
+    void OnDoorOpened(uint32 carIndex);
+
+    // Dispatch idle cars of building which got passengers from other cars
+    void WakeUpIdleCars(uint32 buildingIndex);
+
+    // Select parking floor for idle car. Returns false if car is already there
+    bool ParkCar(uint32 carIndex);
+
+    // Count drive energy of car trip. Returns flight time
+    Milliseconds StartTravel(uint32 carIndex, Floor from, Floor to);
+
+    // Take next arrival of building from buffer. Buffer refilled by trace or traffic model in bulk. Returns false at end of trace
+    static bool FetchArrival(SimulatedBuilding& building);
+
+    SimulationConfig _config;
+
+    // Simulated buildings. Cars of building i have indexes from i * CarCount
+    std::vector<std::unique_ptr<SimulatedBuilding>> _buildings;
+
+    // Flight times between floors of building
+    FlightTimeTable _flightTimes;
+
+    // Drive energy of all trips, J
+    double _energy{};
+
+    // Pending events, earliest first
+    std::priority_queue<SimulationEvent, std::vector<SimulationEvent>, std::greater<>> _events;
+
+    // Control coroutine of every car of all buildings
+    std::vector<CarTask> _carTasks;
+
+    // State of every car
+    std::vector<CarState> _carStates;
+
+    // Target floor of every moving car
+    std::vector<Floor> _carTargets;
+
+    // Floors of other idle cars for parking query
+    std::vector<Floor> _parkedFloors;
+
+    // Current virtual time
+    Milliseconds _now{};
+
+    // Schedule order of next event
+    uint64 _sequence{};
+
+    uint64 _eventCount{};
+};
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "SimulationBatch.h"
+#include "Config.h"
+#include "Random.h"
+#include "StopWatch.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <limits>
+
+namespace
+{
+    void AtomicMin(std::atomic<uint64>& target, uint64 value)
+    {
+        auto current = target.load(std::memory_order_relaxed);
+        while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) { }
+    }
+
+    void AtomicMax(std::atomic<uint64>& target, uint64 value)
+    {
+        auto current = target.load(std::memory_order_relaxed);
+        while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) { }
+    }
+}
+
+/*static*/ SimulationBatchConfig SimulationBatchConfig::LoadFromConfig()
+{
+    SimulationBatchConfig config;
+    config.Base = SimulationConfig::LoadFromConfig();
+    config.RunCount = std::max<uint32>(1, sConfigMgr->GetOption<uint32>("Simulation.Batch.RunCount", 1));
+    config.ThreadCount = sConfigMgr->GetOption<uint32>("Simulation.Batch.ThreadCount", 0);
+    return config;
+}
+
+double SimulationBatchReport::GetSpeedRatio() const
+{
+    if (RealTime == 0us)
+        return 0.0;
+
+    return static_cast<double>(std::chrono::duration_cast<Microseconds>(SimulatedTime).count()) / static_cast<double>(RealTime.count());
+}
+
+SimulationBatch::SimulationBatch(SimulationBatchConfig const& config) :
+    _config(config) { }
+
+SimulationBatchReport SimulationBatch::Run(ConfigureFn const& configure /*= {}*/)
+{
+    StopWatch sw;
+
+    auto baseSeed = _config.Base.Seed ? _config.Base.Seed : std::random_device{}();
+    auto runCount = _config.RunCount;
+
+    SimulationBatchReport report;
+    report.RunCount = runCount;
+    report.Runs.resize(runCount);
+
+    // Lock free aggregation. Every worker writes only own run slots and atomic totals
+    std::atomic<uint32> nextRun{};
+    std::atomic<uint64> simulatedTime{};
+    std::atomic<uint64> eventCount{};
+    std::atomic<uint64> arrivedCount{};
+    std::atomic<uint64> deliveredCount{};
+    std::atomic<uint64> minDelivered{ std::numeric_limits<uint64>::max() };
+    std::atomic<uint64> maxDelivered{};
+
+    auto worker = [&]()
+    {
+        for (auto runIndex = nextRun.fetch_add(1, std::memory_order_relaxed); runIndex < runCount; runIndex = nextRun.fetch_add(1, std::memory_order_relaxed))
+        {
+            SimulationConfig config = _config.Base;
+            config.Seed = Warhead::GetStreamSeed(baseSeed, runIndex);
+
+            if (configure)
+                configure(runIndex, config);
+
+            Simulation simulation(config);
+            auto runReport = simulation.Run();
+
+            simulatedTime.fetch_add(static_cast<uint64>(runReport.SimulatedTime.count()), std::memory_order_relaxed);
+            eventCount.fetch_add(runReport.EventCount, std::memory_order_relaxed);
+            arrivedCount.fetch_add(runReport.ArrivedCount, std::memory_order_relaxed);
+            deliveredCount.fetch_add(runReport.DeliveredCount, std::memory_order_relaxed);
+            AtomicMin(minDelivered, runReport.DeliveredCount);
+            AtomicMax(maxDelivered, runReport.DeliveredCount);
+
+            report.Runs[runIndex] = runReport;
+        }
+    };
+
+    {
+        Warhead::ThreadPool pool(std::min<std::size_t>(_config.ThreadCount ? _config.ThreadCount : std::thread::hardware_concurrency(), runCount));
+        report.ThreadCount = static_cast<uint32>(pool.GetThreadCount());
+
+        for (std::size_t i{}; i < pool.GetThreadCount(); i++)
+            pool.PostWork(worker);
+
+        pool.Wait();
+    }
+
+    report.SimulatedTime = Milliseconds(simulatedTime.load());
+    report.RealTime = sw.Elapsed();
+    report.EventCount = eventCount.load();
+    report.ArrivedCount = arrivedCount.load();
+    report.DeliveredCount = deliveredCount.load();
+    report.MinDelivered = minDelivered.load();
+    report.MaxDelivered = maxDelivered.load();
+    return report;
+}
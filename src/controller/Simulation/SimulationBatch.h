@@ -0,0 +1,80 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_SIMULATION_BATCH_H_
+#define WARHEAD_SIMULATION_BATCH_H_
+
+#include "Simulation.h"
+#include <functional>
+#include <vector>
+
+// Options of many independent simulation runs
+struct WH_CTRL_API SimulationBatchConfig
+{
+    // Load batch options and base simulation options from config
+    static SimulationBatchConfig LoadFromConfig();
+
+    // Options of every run. Seed is base seed of batch
+    SimulationConfig Base;
+
+    // Count of simulation runs
+    uint32 RunCount{ 1 };
+
+    // Count of worker threads. 0 - hardware concurrency
+    uint32 ThreadCount{};
+};
+
+// Aggregated result of all runs in batch
+struct WH_CTRL_API SimulationBatchReport
+{
+    // Total simulated time of all runs to wall clock time ratio
+    [[nodiscard]] double GetSpeedRatio() const;
+
+    uint32 RunCount{};
+    uint32 ThreadCount{};
+    Milliseconds SimulatedTime{};
+    Microseconds RealTime{};
+    uint64 EventCount{};
+    uint64 ArrivedCount{};
+    uint64 DeliveredCount{};
+    uint64 MinDelivered{};
+    uint64 MaxDelivered{};
+
+    // Report of every run by run index
+    std::vector<SimulationReport> Runs;
+};
+
+// Runs isolated simulations in parallel on thread pool.
+// Every run gets seed derived from batch seed and run index, so results don't depend on thread count.
+class WH_CTRL_API SimulationBatch
+{
+public:
+    // Change options of run before start. Seed is already set to run seed
+    using ConfigureFn = std::function<void(uint32 runIndex, SimulationConfig& config)>;
+
+    explicit SimulationBatch(SimulationBatchConfig const& config);
+    ~SimulationBatch() = default;
+
+    // Run all simulations and wait results
+    SimulationBatchReport Run(ConfigureFn const& configure = {});
+
+private:
+    SimulationBatchConfig _config;
+};
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "PassengerStats.h"
+#include "Log.h"
+
+namespace
+{
+    constexpr std::string_view TIME_TYPE_NAMES[MAX_PASSENGER_TIME_TYPE] = { "Wait", "Ride", "Journey" };
+
+    std::string GetSummary(Warhead::LogLinearHistogram const& histogram)
+    {
+        return Warhead::StringFormat("count {}, p50 {}ms, p90 {}ms, p99 {}ms, max {}ms", histogram.GetCount(),
+            histogram.GetPercentile(50.0), histogram.GetPercentile(90.0), histogram.GetPercentile(99.0), histogram.GetMax());
+    }
+}
+
+void PassengerStats::Resize(uint32 floorCount)
+{
+    _floors.assign(std::size_t(floorCount) * MAX_PASSENGER_TIME_TYPE, {});
+
+    for (auto& histogram : _overall)
+        histogram.Clear();
+}
+
+void PassengerStats::Clear()
+{
+    for (auto& histogram : _overall)
+        histogram.Clear();
+
+    for (auto& histogram : _floors)
+        histogram.Clear();
+}
+
+void PassengerStats::Merge(PassengerStats const& other)
+{
+    if (_floors.size() < other._floors.size())
+        _floors.resize(other._floors.size());
+
+    for (std::size_t i{}; i < MAX_PASSENGER_TIME_TYPE; i++)
+        _overall[i].Merge(other._overall[i]);
+
+    for (std::size_t i{}; i < other._floors.size(); i++)
+        _floors[i].Merge(other._floors[i]);
+}
+
+void PassengerStats::LogReport(BuildingGeometry const& geometry) const
+{
+    for (std::size_t i{}; i < MAX_PASSENGER_TIME_TYPE; i++)
+        LOG_INFO("stats", "> {} time: {}", TIME_TYPE_NAMES[i], GetSummary(_overall[i]));
+
+    for (uint32 floorIndex{}; floorIndex < GetFloorCount(); floorIndex++)
+    {
+        if (!Get(PassengerTimeType::Wait, floorIndex).GetCount() && !Get(PassengerTimeType::Journey, floorIndex).GetCount())
+            continue;
+
+        LOG_INFO("stats", "> Floor {}. Wait: {}. Journey: {}", geometry.GetFloorByIndex(floorIndex),
+            GetSummary(Get(PassengerTimeType::Wait, floorIndex)), GetSummary(Get(PassengerTimeType::Journey, floorIndex)));
+    }
+}
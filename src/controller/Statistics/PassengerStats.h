@@ -0,0 +1,98 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_PASSENGER_STATS_H_
+#define WARHEAD_PASSENGER_STATS_H_
+
+#include "Building.h"
+#include "Duration.h"
+#include "Histogram.h"
+#include <vector>
+
+// Measured time of passenger
+enum class PassengerTimeType : uint8
+{
+    Wait,       // From hall call to boarding
+    Ride,       // From boarding to alighting
+    Journey,    // From first hall call to alighting at final destination
+
+    Max
+};
+
+constexpr std::size_t MAX_PASSENGER_TIME_TYPE = static_cast<std::size_t>(PassengerTimeType::Max);
+
+// Histograms of passenger times in milliseconds, overall and by origin floor
+class WH_CTRL_API PassengerStats
+{
+public:
+    PassengerStats() = default;
+    ~PassengerStats() = default;
+
+    // Allocate per floor histograms. Clear all values
+    void Resize(uint32 floorCount);
+    void Clear();
+
+    // Passenger boarded car
+    inline void AddWait(uint32 floorIndex, Milliseconds wait)
+    {
+        Add(PassengerTimeType::Wait, floorIndex, wait);
+    }
+
+    // Passenger left car at transfer floor
+    inline void AddRide(uint32 floorIndex, Milliseconds ride)
+    {
+        Add(PassengerTimeType::Ride, floorIndex, ride);
+    }
+
+    // Passenger reached destination
+    inline void AddTrip(uint32 floorIndex, Milliseconds ride, Milliseconds journey)
+    {
+        Add(PassengerTimeType::Ride, floorIndex, ride);
+        Add(PassengerTimeType::Journey, floorIndex, journey);
+    }
+
+    // Add values of other stats with same floor count
+    void Merge(PassengerStats const& other);
+
+    // Histogram of all floors
+    [[nodiscard]] inline Warhead::LogLinearHistogram const& Get(PassengerTimeType type) const { return _overall[static_cast<std::size_t>(type)]; }
+
+    // Histogram of origin floor
+    [[nodiscard]] inline Warhead::LogLinearHistogram const& Get(PassengerTimeType type, uint32 floorIndex) const { return _floors[floorIndex * MAX_PASSENGER_TIME_TYPE + static_cast<std::size_t>(type)]; }
+
+    [[nodiscard]] inline uint32 GetFloorCount() const { return static_cast<uint32>(_floors.size() / MAX_PASSENGER_TIME_TYPE); }
+
+    // Log p50/p90/p99/max of all times overall and for every floor with passengers
+    void LogReport(BuildingGeometry const& geometry) const;
+
+private:
+    inline void Add(PassengerTimeType type, uint32 floorIndex, Milliseconds time)
+    {
+        auto value = static_cast<uint64>(std::max<Milliseconds::rep>(time.count(), 0));
+
+        _overall[static_cast<std::size_t>(type)].Add(value);
+        _floors[floorIndex * MAX_PASSENGER_TIME_TYPE + static_cast<std::size_t>(type)].Add(value);
+    }
+
+    Warhead::LogLinearHistogram _overall[MAX_PASSENGER_TIME_TYPE];
+
+    // Floor count by time type histograms
+    std::vector<Warhead::LogLinearHistogram> _floors;
+};
+
+#endif
@@ -0,0 +1,214 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "PassengerTrace.h"
+#include "Log.h"
+#include <bit>
+#include <cstring>
+#include <limits>
+
+static_assert(std::endian::native == std::endian::little, "Passenger trace is stored in host byte order and needs little endian host");
+
+namespace
+{
+    // Records written to file at once
+    constexpr std::size_t BUFFER_RECORD_COUNT = 8192;
+
+    constexpr uint32 MAX_TIME_DELTA = std::numeric_limits<uint32>::max();
+}
+
+PassengerTraceWriter::~PassengerTraceWriter()
+{
+    Close();
+}
+
+bool PassengerTraceWriter::Open(std::string const& path)
+{
+    Close();
+
+    std::lock_guard guard(_lock);
+
+    _file = std::fopen(path.c_str(), "wb");
+    if (!_file)
+    {
+        LOG_ERROR("trace", "> Trace: Can't create file '{}'", path);
+        return false;
+    }
+
+    uint8 header[PassengerTrace::HEADER_SIZE]{};
+    uint16 version = PassengerTrace::VERSION;
+    uint16 recordSize = PassengerTrace::RECORD_SIZE;
+
+    std::memcpy(header, &PassengerTrace::MAGIC, 4);
+    std::memcpy(header + 4, &version, 2);
+    std::memcpy(header + 6, &recordSize, 2);
+    std::fwrite(header, 1, sizeof(header), _file);
+
+    _buffer.reserve(BUFFER_RECORD_COUNT * PassengerTrace::RECORD_SIZE);
+    _lastTime = 0ms;
+    _recordCount = 0;
+    return true;
+}
+
+void PassengerTraceWriter::Close()
+{
+    std::lock_guard guard(_lock);
+
+    if (!_file)
+        return;
+
+    FlushBuffer();
+    std::fclose(_file);
+    _file = nullptr;
+}
+
+void PassengerTraceWriter::Record(Milliseconds time, Floor origin, Floor destination)
+{
+    if (origin == PassengerTrace::TIME_ONLY_FLOOR)
+        return;
+
+    std::lock_guard guard(_lock);
+
+    if (!_file)
+        return;
+
+    auto delta = static_cast<uint64>(std::max(time - _lastTime, 0ms).count());
+    _lastTime = std::max(time, _lastTime);
+
+    // Delta doesn't fit in record. Add time only records
+    for (; delta > MAX_TIME_DELTA; delta -= MAX_TIME_DELTA)
+        WriteRecord(MAX_TIME_DELTA, PassengerTrace::TIME_ONLY_FLOOR, PassengerTrace::TIME_ONLY_FLOOR);
+
+    WriteRecord(static_cast<uint32>(delta), origin, destination);
+    _recordCount++;
+}
+
+void PassengerTraceWriter::Flush()
+{
+    std::lock_guard guard(_lock);
+    FlushBuffer();
+}
+
+uint64 PassengerTraceWriter::GetRecordCount() const
+{
+    std::lock_guard guard(_lock);
+    return _recordCount;
+}
+
+void PassengerTraceWriter::FlushBuffer()
+{
+    if (!_file || _buffer.empty())
+        return;
+
+    std::fwrite(_buffer.data(), 1, _buffer.size(), _file);
+    std::fflush(_file);
+    _buffer.clear();
+}
+
+void PassengerTraceWriter::WriteRecord(uint32 timeDelta, Floor origin, Floor destination)
+{
+    auto offset = _buffer.size();
+    _buffer.resize(offset + PassengerTrace::RECORD_SIZE);
+
+    std::memcpy(_buffer.data() + offset, &timeDelta, 4);
+    std::memcpy(_buffer.data() + offset + 4, &origin, 2);
+    std::memcpy(_buffer.data() + offset + 6, &destination, 2);
+
+    if (_buffer.size() >= BUFFER_RECORD_COUNT * PassengerTrace::RECORD_SIZE)
+        FlushBuffer();
+}
+
+bool PassengerTraceReader::Open(std::string const& path)
+{
+    Close();
+
+    if (!_file.Open(path))
+    {
+        LOG_ERROR("trace", "> Trace: Can't open file '{}'", path);
+        return false;
+    }
+
+    uint32 magic{};
+    uint16 version{};
+    uint16 recordSize{};
+
+    if (_file.GetSize() >= PassengerTrace::HEADER_SIZE)
+    {
+        std::memcpy(&magic, _file.GetData(), 4);
+        std::memcpy(&version, _file.GetData() + 4, 2);
+        std::memcpy(&recordSize, _file.GetData() + 6, 2);
+    }
+
+    bool knownVersion = version == PassengerTrace::VERSION || version == PassengerTrace::SAME_FLOOR_MARKER_VERSION;
+
+    if (magic != PassengerTrace::MAGIC || !knownVersion || recordSize != PassengerTrace::RECORD_SIZE)
+    {
+        LOG_ERROR("trace", "> Trace: File '{}' is not passenger trace version {}", path, PassengerTrace::VERSION);
+        Close();
+        return false;
+    }
+
+    _version = version;
+    _recordCount = (_file.GetSize() - PassengerTrace::HEADER_SIZE) / PassengerTrace::RECORD_SIZE;
+    Rewind();
+    return true;
+}
+
+void PassengerTraceReader::Close()
+{
+    _file.Close();
+    _version = 0;
+    _recordCount = 0;
+    Rewind();
+}
+
+std::size_t PassengerTraceReader::Read(std::span<TrafficArrival> arrivals)
+{
+    if (!_file.GetData())
+        return 0;
+
+    auto record = _file.GetData() + PassengerTrace::HEADER_SIZE + _nextRecord * PassengerTrace::RECORD_SIZE;
+    std::size_t count{};
+
+    for (; count < arrivals.size() && _nextRecord < _recordCount; _nextRecord++, record += PassengerTrace::RECORD_SIZE)
+    {
+        uint32 timeDelta{};
+        Floor origin{};
+        Floor destination{};
+
+        std::memcpy(&timeDelta, record, 4);
+        std::memcpy(&origin, record + 4, 2);
+        std::memcpy(&destination, record + 6, 2);
+
+        _time += Milliseconds(timeDelta);
+
+        bool timeOnly = _version == PassengerTrace::SAME_FLOOR_MARKER_VERSION ? origin == destination : origin == PassengerTrace::TIME_ONLY_FLOOR;
+        if (timeOnly)
+            continue;
+
+        arrivals[count++] = { _time, origin, destination };
+    }
+
+    return count;
+}
+
+void PassengerTraceReader::Rewind()
+{
+    _nextRecord = 0;
+    _time = 0ms;
+}
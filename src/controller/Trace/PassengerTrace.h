@@ -0,0 +1,116 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_PASSENGER_TRACE_H_
+#define WARHEAD_PASSENGER_TRACE_H_
+
+#include "MappedFile.h"
+#include "TrafficModel.h"
+#include <cstdio>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+// Binary passenger trace.
+// File starts with 8 byte header: magic "WHPT", version (uint16), record size (uint16).
+// Then fixed 8 byte records: time delta from previous record in ms (uint32), origin (int16), destination (int16).
+// All values are little endian. Record with TIME_ONLY_FLOOR origin only advances time.
+// Version 1 files marked time only records with same origin and destination, they are still readable
+namespace PassengerTrace
+{
+    constexpr uint32 MAGIC = 0x54504857; // "WHPT"
+    constexpr uint16 VERSION = 2;
+    constexpr uint16 SAME_FLOOR_MARKER_VERSION = 1;
+    constexpr std::size_t HEADER_SIZE = 8;
+    constexpr std::size_t RECORD_SIZE = 8;
+
+    // Reserved origin of time only records. Passengers can't start on this floor
+    constexpr Floor TIME_ONLY_FLOOR = std::numeric_limits<Floor>::min();
+}
+
+// Writes passengers in binary trace. Records are buffered and written in large blocks.
+// Thread safe, cars of one group can share writer
+class WH_CTRL_API PassengerTraceWriter
+{
+public:
+    PassengerTraceWriter() = default;
+    ~PassengerTraceWriter();
+
+    PassengerTraceWriter(PassengerTraceWriter const&) = delete;
+    PassengerTraceWriter& operator=(PassengerTraceWriter const&) = delete;
+
+    // Create or truncate trace file and write header
+    bool Open(std::string const& path);
+
+    // Flush buffer and close file
+    void Close();
+
+    [[nodiscard]] inline bool IsOpen() const { return _file != nullptr; }
+
+    // Add passenger arrived at time. Time before previous record is written as previous time.
+    // Passenger with TIME_ONLY_FLOOR origin is not recorded
+    void Record(Milliseconds time, Floor origin, Floor destination);
+
+    // Write buffered records to file
+    void Flush();
+
+    // Count of passenger records
+    [[nodiscard]] uint64 GetRecordCount() const;
+
+private:
+    void WriteRecord(uint32 timeDelta, Floor origin, Floor destination);
+    void FlushBuffer();
+
+    mutable std::mutex _lock;
+    std::FILE* _file{};
+    std::vector<uint8> _buffer;
+    Milliseconds _lastTime{};
+    uint64 _recordCount{};
+};
+
+// Streams passengers from memory mapped binary trace
+class WH_CTRL_API PassengerTraceReader
+{
+public:
+    PassengerTraceReader() = default;
+    ~PassengerTraceReader() = default;
+
+    // Map trace file and check header
+    bool Open(std::string const& path);
+    void Close();
+
+    [[nodiscard]] inline bool IsOpen() const { return _file.IsOpen(); }
+
+    // Read next passengers. Returns count of read passengers, 0 at end of trace
+    std::size_t Read(std::span<TrafficArrival> arrivals);
+
+    // Start reading from first record
+    void Rewind();
+
+    // Count of records in file, including time only records
+    [[nodiscard]] inline std::size_t GetRecordCount() const { return _recordCount; }
+
+private:
+    Warhead::MappedFile _file;
+    uint16 _version{};
+    std::size_t _recordCount{};
+    std::size_t _nextRecord{};
+    Milliseconds _time{};
+};
+
+#endif
@@ -0,0 +1,221 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TrafficModel.h"
+#include "Config.h"
+#include "Log.h"
+#include <fstream>
+#include <algorithm>
+
+/*static*/ TrafficConfig TrafficConfig::LoadFromConfig()
+{
+    TrafficConfig config;
+    TrafficConfig const defaultConfig;
+
+    auto profile = sConfigMgr->GetOption<uint8>("Traffic.Profile", static_cast<uint8>(defaultConfig.Profile));
+    if (profile > static_cast<uint8>(TrafficProfile::Matrix))
+    {
+        LOG_ERROR("traffic", "> Traffic: Unknown profile {}. Use uniform", profile);
+        profile = static_cast<uint8>(TrafficProfile::Uniform);
+    }
+
+    config.Profile = static_cast<TrafficProfile>(profile);
+    config.PassengersPerHour = sConfigMgr->GetOption<uint32>("Traffic.PassengersPerHour", defaultConfig.PassengersPerHour);
+    config.LobbyShare = std::clamp<double>(sConfigMgr->GetOption<float>("Traffic.LobbyShare", static_cast<float>(defaultConfig.LobbyShare)), 0.0, 1.0);
+
+    if (config.Profile == TrafficProfile::Matrix)
+    {
+        auto path = sConfigMgr->GetOption<std::string>("Traffic.MatrixFile", "");
+
+        std::ifstream file(path);
+        if (!file.is_open())
+            LOG_ERROR("traffic", "> Traffic: Can't open matrix file '{}'", path);
+
+        for (double weight{}; file >> weight;)
+            config.Matrix.emplace_back(weight);
+    }
+
+    return config;
+}
+
+TrafficModel::TrafficModel(BuildingGeometry const& geometry, TrafficConfig const& config, uint64 seed) :
+    _geometry(geometry), _ratePerMs(static_cast<double>(config.PassengersPerHour) / static_cast<double>(Milliseconds(1h).count())),
+    _generator(seed)
+{
+    BuildAliasTable(GetProfileMatrix(geometry, config));
+}
+
+TrafficArrival TrafficModel::Next()
+{
+    TrafficArrival arrival;
+    Generate({ &arrival, 1 });
+    return arrival;
+}
+
+void TrafficModel::Generate(std::span<TrafficArrival> arrivals)
+{
+    auto const floorCount = _geometry.GetFloorCount();
+    auto const pairCount = static_cast<uint32>(_alias.size());
+
+    for (auto& arrival : arrivals)
+    {
+        _time += _generator.NextExponential(_ratePerMs);
+
+        auto pairIndex = _generator.NextBelow(pairCount);
+        if (_generator.NextDouble() >= _probability[pairIndex])
+            pairIndex = _alias[pairIndex];
+
+        arrival.Time = Milliseconds(static_cast<Milliseconds::rep>(_time));
+        arrival.Origin = _geometry.GetFloorByIndex(pairIndex / floorCount);
+        arrival.Destination = _geometry.GetFloorByIndex(pairIndex % floorCount);
+    }
+}
+
+/*static*/ std::vector<double> TrafficModel::GetProfileMatrix(BuildingGeometry const& geometry, TrafficConfig const& config)
+{
+    auto const floorCount = geometry.GetFloorCount();
+    auto const lobbyIndex = geometry.GetFloorIndex(geometry.LobbyFloor);
+
+    if (config.Profile == TrafficProfile::Matrix)
+    {
+        if (config.Matrix.size() == std::size_t(floorCount) * floorCount)
+            return config.Matrix;
+
+        LOG_ERROR("traffic", "> Traffic: Matrix has {} weights, need {} for {} floors. Use uniform", config.Matrix.size(), std::size_t(floorCount) * floorCount, floorCount);
+    }
+
+    // Share of trips from lobby, to lobby and between other floors
+    double upShare{ 1.0 }, downShare{ 1.0 }, interShare{ 1.0 };
+
+    switch (config.Profile)
+    {
+        case TrafficProfile::UpPeak:
+            upShare = config.LobbyShare;
+            downShare = 0.0;
+            interShare = 1.0 - config.LobbyShare;
+            break;
+        case TrafficProfile::DownPeak:
+            upShare = 0.0;
+            downShare = config.LobbyShare;
+            interShare = 1.0 - config.LobbyShare;
+            break;
+        case TrafficProfile::Lunch:
+            upShare = 0.45;
+            downShare = 0.45;
+            interShare = 0.1;
+            break;
+        case TrafficProfile::InterFloor:
+            upShare = 0.0;
+            downShare = 0.0;
+            break;
+        default:
+            break;
+    }
+
+    // Uniform profile uses same weight for every pair, others split shares between pairs of group
+    double const otherFloors = floorCount - 1.0;
+    double const interPairs = otherFloors * (floorCount - 2.0);
+    bool const uniform = config.Profile == TrafficProfile::Uniform || config.Profile == TrafficProfile::Matrix;
+
+    std::vector<double> weights(std::size_t(floorCount) * floorCount);
+
+    for (uint32 origin{}; origin < floorCount; origin++)
+    {
+        for (uint32 destination{}; destination < floorCount; destination++)
+        {
+            if (origin == destination)
+                continue;
+
+            double weight{ 1.0 };
+
+            if (!uniform)
+            {
+                if (origin == lobbyIndex)
+                    weight = upShare / otherFloors;
+                else if (destination == lobbyIndex)
+                    weight = downShare / otherFloors;
+                else
+                    weight = interShare / interPairs;
+            }
+
+            weights[std::size_t(origin) * floorCount + destination] = weight;
+        }
+    }
+
+    return weights;
+}
+
+void TrafficModel::BuildAliasTable(std::vector<double> const& weights)
+{
+    _probability.clear();
+    _alias.clear();
+
+    double total{};
+    for (auto weight : weights)
+        if (weight > 0.0)
+            total += weight;
+
+    // No trips. For example building with one floor
+    if (total <= 0.0)
+        return;
+
+    auto const count = static_cast<uint32>(weights.size());
+
+    _probability.resize(count);
+    _alias.resize(count);
+
+    // Vose alias method
+    std::vector<uint32> small, large;
+    small.reserve(count);
+    large.reserve(count);
+
+    for (uint32 i{}; i < count; i++)
+    {
+        _probability[i] = std::max(weights[i], 0.0) * count / total;
+        _alias[i] = i;
+
+        if (_probability[i] < 1.0)
+            small.emplace_back(i);
+        else
+            large.emplace_back(i);
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        auto less = small.back();
+        small.pop_back();
+
+        auto more = large.back();
+
+        _alias[less] = more;
+        _probability[more] -= 1.0 - _probability[less];
+
+        if (_probability[more] < 1.0)
+        {
+            large.pop_back();
+            small.emplace_back(more);
+        }
+    }
+
+    // Remains are full because of rounding
+    for (auto i : small)
+        _probability[i] = 1.0;
+
+    for (auto i : large)
+        _probability[i] = 1.0;
+}
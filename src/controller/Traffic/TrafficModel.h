@@ -0,0 +1,104 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WARHEAD_TRAFFIC_MODEL_H_
+#define WARHEAD_TRAFFIC_MODEL_H_
+
+#include "Building.h"
+#include "Duration.h"
+#include "Random.h"
+#include <span>
+#include <vector>
+
+// Shape of passenger traffic between floors
+enum class TrafficProfile : uint8
+{
+    Uniform,        // All floor pairs with same probability
+    UpPeak,         // Morning. Most trips from lobby up to floors
+    DownPeak,       // Evening. Most trips from floors down to lobby
+    Lunch,          // Trips to and from lobby with some inter floor trips
+    InterFloor,     // Trips between floors without lobby
+    Matrix          // Configured origin-destination matrix
+};
+
+// Options of passenger traffic
+struct WH_CTRL_API TrafficConfig
+{
+    // Load traffic options from config
+    static TrafficConfig LoadFromConfig();
+
+    TrafficProfile Profile{ TrafficProfile::Uniform };
+
+    // Average count of new passengers per hour. Arrivals are Poisson distributed
+    uint32 PassengersPerHour{ 600 };
+
+    // Share of lobby trips in up-peak and down-peak profiles
+    double LobbyShare{ 0.85 };
+
+    // Origin-destination weights for matrix profile. Floor count rows by floor count columns, row is origin floor
+    std::vector<double> Matrix;
+};
+
+// New passenger generated by traffic model
+struct TrafficArrival
+{
+    Milliseconds Time{};
+    Floor Origin{};
+    Floor Destination{};
+};
+
+// Generator of passenger arrivals with own random stream.
+// Trips are sampled from origin-destination weights with alias table in O(1)
+class WH_CTRL_API TrafficModel
+{
+public:
+    TrafficModel(BuildingGeometry const& geometry, TrafficConfig const& config, uint64 seed);
+    ~TrafficModel() = default;
+
+    // Model can generate passengers
+    [[nodiscard]] inline bool IsEnabled() const { return _ratePerMs > 0.0 && !_alias.empty(); }
+
+    // Generate next arrival. Arrival times are not decreasing
+    TrafficArrival Next();
+
+    // Generate next arrivals in bulk
+    void Generate(std::span<TrafficArrival> arrivals);
+
+    // Origin-destination weights of profile for building
+    static std::vector<double> GetProfileMatrix(BuildingGeometry const& geometry, TrafficConfig const& config);
+
+private:
+    // Build alias table from origin-destination weights
+    void BuildAliasTable(std::vector<double> const& weights);
+
+    BuildingGeometry _geometry;
+
+    // Average arrivals per millisecond
+    double _ratePerMs{};
+
+    // Time of last arrival in milliseconds
+    double _time{};
+
+    Warhead::Xoshiro256 _generator;
+
+    // Alias table over origin-destination pairs: pair index is origin index * floor count + destination index
+    std::vector<double> _probability;
+    std::vector<uint32> _alias;
+};
+
+#endif
@@ -0,0 +1,230 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "CallAllocator.h"
+#include "ElevatorGroup.h"
+#include "Simulation.h"
+
+namespace
+{
+    // Two idle cars on lobby. All hall calls are served by first car
+    AllocationProblem MakeUnbalancedProblem()
+    {
+        AllocationProblem problem;
+        problem.Timing = { 1000ms, 5000ms };
+        problem.Cars.push_back({ 0, MovementType::Up, 0, 0 });
+        problem.Cars.push_back({ 0, MovementType::Up, 0, 0 });
+
+        for (uint32 floorIndex = 5; floorIndex < 20; floorIndex += 5)
+        {
+            AllocationCall call{ floorIndex, MovementType::Down, 2, 0 };
+            call.FirstDestinationStop = static_cast<uint32>(problem.DestinationStops.size());
+            call.DestinationStopCount = 1;
+            problem.Calls.emplace_back(call);
+            problem.DestinationStops.push_back({ 0, 2 });
+        }
+
+        return problem;
+    }
+
+    CallAllocatorConfig MakeConfig(Microseconds budget)
+    {
+        CallAllocatorConfig config;
+        config.Interval = 1s;
+        config.Budget = budget;
+        config.ThreadCount = 2;
+        config.Seed = 12345;
+        return config;
+    }
+}
+
+TEST_CASE("Call allocator")
+{
+    SECTION("Search moves calls to idle car")
+    {
+        CallAllocator allocator(MakeConfig(20ms));
+
+        auto problem = MakeUnbalancedProblem();
+        REQUIRE(allocator.Start(problem));
+
+        auto plan = allocator.WaitPlan();
+        REQUIRE(plan);
+        REQUIRE_FALSE(plan->Moves.empty());
+        REQUIRE(plan->Cost < plan->InitialCost);
+        REQUIRE(plan->Iterations > 0);
+
+        for (auto const& move : plan->Moves)
+        {
+            REQUIRE(move.FromCar == 0);
+            REQUIRE(move.ToCar == 1);
+        }
+
+        // Plan is taken once
+        REQUIRE_FALSE(allocator.TakePlan());
+    }
+
+    SECTION("Second start fails while search runs")
+    {
+        CallAllocator allocator(MakeConfig(10s));
+
+        auto problem = MakeUnbalancedProblem();
+        REQUIRE(allocator.Start(problem));
+
+        auto next = MakeUnbalancedProblem();
+        REQUIRE_FALSE(allocator.Start(next));
+
+        allocator.Cancel();
+        allocator.WaitPlan();
+        REQUIRE_FALSE(allocator.IsRunning());
+    }
+
+    SECTION("Iteration limit gives same plan")
+    {
+        auto config = MakeConfig(10s);
+        config.Iterations = 1000;
+        config.ChainCount = 3;
+
+        CallAllocator first(config);
+        CallAllocator second(config);
+
+        auto firstProblem = MakeUnbalancedProblem();
+        auto secondProblem = MakeUnbalancedProblem();
+        REQUIRE(first.Start(firstProblem));
+        REQUIRE(second.Start(secondProblem));
+
+        auto firstPlan = first.WaitPlan();
+        auto secondPlan = second.WaitPlan();
+        REQUIRE(firstPlan);
+        REQUIRE(secondPlan);
+        REQUIRE(firstPlan->Iterations == 3000);
+        REQUIRE(firstPlan->Cost == secondPlan->Cost);
+        REQUIRE(firstPlan->Moves.size() == secondPlan->Moves.size());
+
+        for (std::size_t i{}; i < firstPlan->Moves.size(); i++)
+        {
+            REQUIRE(firstPlan->Moves[i].FloorIndex == secondPlan->Moves[i].FloorIndex);
+            REQUIRE(firstPlan->Moves[i].ToCar == secondPlan->Moves[i].ToCar);
+        }
+    }
+
+    SECTION("Inline search publishes plan in start")
+    {
+        auto config = MakeConfig(10s);
+        config.Iterations = 1000;
+        config.IsInline = true;
+
+        CallAllocator allocator(config);
+
+        auto problem = MakeUnbalancedProblem();
+        REQUIRE(allocator.Start(problem));
+        REQUIRE_FALSE(allocator.IsRunning());
+
+        auto plan = allocator.TakePlan();
+        REQUIRE(plan);
+        REQUIRE(plan->Iterations == 1000);
+        REQUIRE(plan->Cost < plan->InitialCost);
+    }
+
+    SECTION("Group moves waiting passengers")
+    {
+        ElevatorGroup group(2, { 1, 20, 1 });
+        group.SetEtaTiming({ 1000ms, 5000ms });
+        group.SetReallocation(MakeConfig(20ms));
+
+        auto car = group.GetCar(0);
+        for (Floor floor = 5; floor <= 20; floor += 5)
+        {
+            car->AddPassenger(floor, 1);
+            car->AddPassenger(floor, 1);
+        }
+
+        REQUIRE(group.StartReallocation());
+        REQUIRE(group.WaitReallocation() > 0);
+        REQUIRE(group.GetCar(1)->GetWaitingCount() > 0);
+        REQUIRE(group.GetCar(0)->GetWaitingCount() + group.GetCar(1)->GetWaitingCount() == 8);
+    }
+
+    SECTION("Group update applies plan without waiting")
+    {
+        auto config = MakeConfig(10s);
+        config.Iterations = 1000;
+        config.IsInline = true;
+
+        ElevatorGroup group(2, { 1, 20, 1 });
+        group.SetEtaTiming({ 1000ms, 5000ms });
+        group.SetReallocation(config);
+
+        auto car = group.GetCar(0);
+        for (Floor floor = 5; floor <= 20; floor += 5)
+        {
+            car->AddPassenger(floor, 1);
+            car->AddPassenger(floor, 1);
+        }
+
+        // Search starts only after interval
+        group.Update(500ms);
+        REQUIRE(group.GetReallocatedCount() == 0);
+        REQUIRE(group.UpdateReallocation(0ms) == 0);
+
+        // Plan of search started by first tick is applied by next one
+        group.Update(500ms);
+        group.Update(100ms);
+
+        REQUIRE(group.GetReallocatedCount() > 0);
+    }
+
+    SECTION("Simulation with reallocation delivers passengers")
+    {
+        SimulationConfig config;
+        config.Geometry.MaxFloor = 20;
+        config.CarCount = 4;
+        config.Duration = 30min;
+        config.Traffic.PassengersPerHour = 600;
+        config.Seed = 12345;
+        config.Reallocation = MakeConfig(200us);
+
+        Simulation simulation(config);
+        auto report = simulation.Run();
+
+        REQUIRE(report.ArrivedCount > 200);
+        REQUIRE(report.DeliveredCount > report.ArrivedCount - 20);
+    }
+
+    SECTION("Same seed gives same simulation with reallocation")
+    {
+        SimulationConfig config;
+        config.Geometry.MaxFloor = 20;
+        config.CarCount = 4;
+        config.Duration = 30min;
+        config.Traffic.PassengersPerHour = 600;
+        config.Seed = 12345;
+        config.Reallocation = MakeConfig(200us);
+
+        Simulation first(config);
+        Simulation second(config);
+
+        auto firstReport = first.Run();
+        auto secondReport = second.Run();
+
+        REQUIRE(firstReport.ReallocatedCount > 0);
+        REQUIRE(firstReport.ReallocatedCount == secondReport.ReallocatedCount);
+        REQUIRE(firstReport.EventCount == secondReport.EventCount);
+        REQUIRE(firstReport.DeliveredCount == secondReport.DeliveredCount);
+    }
+}
@@ -0,0 +1,137 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "DemandModel.h"
+#include "Elevator.h"
+#include <array>
+
+namespace
+{
+    BuildingGeometry GetTallGeometry()
+    {
+        BuildingGeometry geometry;
+        geometry.MaxFloor = 20;
+        return geometry;
+    }
+}
+
+TEST_CASE("Demand model")
+{
+    SECTION("Nothing learned parks at lobby")
+    {
+        DemandModel model(GetTallGeometry());
+
+        REQUIRE(model.GetParkingFloor(1h, 10, {}) == 1);
+        REQUIRE(model.GetDemandShare(1h, 10) == 0.0);
+    }
+
+    SECTION("Idle car parks on floor with most calls")
+    {
+        DemandModel model(GetTallGeometry());
+
+        for (int i = 0; i < 10; i++)
+            model.AddArrival(8h, 12);
+
+        model.AddArrival(8h, 3);
+
+        REQUIRE(model.GetArrivalCount() == 11);
+        REQUIRE(model.GetDemandShare(8h, 12) == Approx(10.0 / 11.0));
+        REQUIRE(model.GetParkingFloor(8h + 10min, 1, {}) == 12);
+    }
+
+    SECTION("Demand is learned per time of day")
+    {
+        DemandModel model(GetTallGeometry());
+
+        for (int day = 0; day < 3; day++)
+        {
+            model.AddArrival(Hours(24 * day) + 8h, 1);
+            model.AddArrival(Hours(24 * day) + 18h, 15);
+        }
+
+        REQUIRE(model.GetParkingFloor(Hours(72) + 8h, 10, {}) == 1);
+        REQUIRE(model.GetParkingFloor(Hours(72) + 18h, 10, {}) == 15);
+    }
+
+    SECTION("Old calls decay")
+    {
+        DemandModelConfig config;
+        config.HalfLife = 1h;
+
+        DemandModel model(GetTallGeometry(), config);
+
+        for (int i = 0; i < 100; i++)
+            model.AddArrival(8h, 2);
+
+        // Same time of day after 10 days. Old weight is 2^-240
+        model.AddArrival(Hours(240) + 8h, 18);
+
+        REQUIRE(model.GetDemandShare(Hours(240) + 8h, 18) == Approx(1.0));
+    }
+
+    SECTION("Other idle car covers its floor")
+    {
+        DemandModel model(GetTallGeometry());
+
+        for (int i = 0; i < 10; i++)
+        {
+            model.AddArrival(8h, 2);
+            model.AddArrival(8h, 18);
+        }
+
+        std::array<Floor, 1> otherCars{ 2 };
+        REQUIRE(model.GetParkingFloor(8h, 2, otherCars) == 18);
+    }
+
+    SECTION("Small gain keeps car on floor")
+    {
+        DemandModel model(GetTallGeometry());
+        model.AddArrival(8h, 9);
+        model.AddArrival(8h, 10);
+        model.AddArrival(8h, 11);
+
+        REQUIRE(model.GetParkingFloor(8h, 10, {}) == 10);
+        REQUIRE(model.GetParkingFloor(8h, 11, {}) == 11);
+        REQUIRE(model.GetParkingFloor(8h, 12, {}) == 10);
+    }
+
+    SECTION("Idle car parks again only after demand changes")
+    {
+        DemandModel model(GetTallGeometry());
+        for (uint32 i{}; i < 10; i++)
+            model.AddArrival(8h, 15);
+
+        Elevator elevator(GetTallGeometry());
+        elevator.SetDemandModel(&model);
+        elevator.SetClock(8h);
+
+        // Car without flight times reaches parking floor in same update
+        elevator.Update(1s);
+        REQUIRE(elevator.GetCurrentFloor() == 15);
+
+        elevator.Update(1s);
+        REQUIRE(elevator.GetCurrentFloor() == 15);
+
+        for (uint32 i{}; i < 100; i++)
+            model.AddArrival(8h, 3);
+
+        elevator.Update(1s);
+        REQUIRE(elevator.GetCurrentFloor() == 3);
+    }
+}
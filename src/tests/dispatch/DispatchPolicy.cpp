@@ -0,0 +1,82 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "Elevator.h"
+#include "Simulation.h"
+
+TEST_CASE("Dispatch policies")
+{
+    SECTION("Registry creates policy by name")
+    {
+        auto names = DispatchPolicyRegistry::GetNames();
+        REQUIRE(names.size() == std::variant_size_v<AnyDispatchPolicy>);
+
+        for (auto name : names)
+        {
+            auto policy = DispatchPolicyRegistry::Create(name);
+            REQUIRE(policy);
+            REQUIRE(DispatchPolicyRegistry::GetName(*policy) == name);
+        }
+
+        REQUIRE_FALSE(DispatchPolicyRegistry::Create("Unknown"));
+    }
+
+    SECTION("Nearest in direction keeps movement")
+    {
+        Elevator elevator;
+        elevator.SetCurrentFloor(5, MovementType::Up);
+        elevator.AddPassengerToElevator(4);
+        elevator.AddPassengerToElevator(9);
+
+        REQUIRE(elevator.GetNextFloor(NearestInDirectionPolicy{}) == 9);
+        REQUIRE(elevator.GetNextFloor() == 9);
+    }
+
+    SECTION("Nearest call ignores movement")
+    {
+        Elevator elevator;
+        elevator.SetDispatchPolicy(NearestCallPolicy{});
+        elevator.SetCurrentFloor(5, MovementType::Up);
+        elevator.AddPassengerToElevator(4);
+        elevator.AddPassengerToElevator(9);
+
+        REQUIRE(elevator.GetNextFloor(NearestCallPolicy{}) == 4);
+        REQUIRE(elevator.GetNextFloor() == 4);
+    }
+
+    SECTION("Simulation with every policy delivers passengers")
+    {
+        for (auto name : DispatchPolicyRegistry::GetNames())
+        {
+            SimulationConfig config;
+            config.Geometry.MaxFloor = 20;
+            config.CarCount = 2;
+            config.Duration = 1h;
+            config.Traffic.PassengersPerHour = 300;
+            config.Seed = 12345;
+            config.Policy = *DispatchPolicyRegistry::Create(name);
+
+            Simulation simulation(config);
+            auto report = simulation.Run();
+
+            REQUIRE(report.ArrivedCount > 200);
+            REQUIRE(report.DeliveredCount > report.ArrivedCount - 20);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "ElevatorGroup.h"
+
+namespace
+{
+    constexpr EtaTiming TEST_TIMING{ 1000ms, 5000ms };
+
+    Milliseconds GetEta(EtaTable const& table, Elevator const& car, Floor floor, MovementType direction)
+    {
+        return table.Get(car.GetGeometry().GetFloorIndex(floor), direction);
+    }
+}
+
+TEST_CASE("ETA table")
+{
+    BuildingGeometry geometry;
+    geometry.MaxFloor = 10;
+
+    Elevator car(geometry);
+    EtaTable table;
+
+    SECTION("Idle car travels straight to call")
+    {
+        car.SetCurrentFloor(4, MovementType::Up);
+        car.UpdateEtaTable(table, TEST_TIMING);
+
+        REQUIRE(GetEta(table, car, 4, MovementType::Up) == 0ms);
+        REQUIRE(GetEta(table, car, 9, MovementType::Down) == 5s);
+        REQUIRE(GetEta(table, car, 1, MovementType::Up) == 3s);
+    }
+
+    SECTION("Busy car serves stops in direction first")
+    {
+        car.SetCurrentFloor(3, MovementType::Up);
+        car.AddPassengerToElevator(7);
+        car.UpdateEtaTable(table, TEST_TIMING);
+
+        // On the way up
+        REQUIRE(GetEta(table, car, 5, MovementType::Up) == 2s);
+        REQUIRE(GetEta(table, car, 9, MovementType::Up) == 11s);
+        REQUIRE(GetEta(table, car, 8, MovementType::Down) == 10s);
+
+        // After turn around at floor 7
+        REQUIRE(GetEta(table, car, 5, MovementType::Down) == 11s);
+        REQUIRE(GetEta(table, car, 1, MovementType::Down) == 15s);
+        REQUIRE(GetEta(table, car, 2, MovementType::Up) == 14s);
+    }
+
+    SECTION("Table rebuilt only when car state changes")
+    {
+        car.UpdateEtaTable(table, TEST_TIMING);
+        REQUIRE(table.IsValid(car.GetStateVersion()));
+
+        car.SetClock(10s);
+        REQUIRE(table.IsValid(car.GetStateVersion()));
+
+        car.AddPassenger(5, 2);
+        REQUIRE_FALSE(table.IsValid(car.GetStateVersion()));
+
+        car.UpdateEtaTable(table, TEST_TIMING);
+        REQUIRE(table.IsValid(car.GetStateVersion()));
+
+        car.MoveTo(5);
+        REQUIRE_FALSE(table.IsValid(car.GetStateVersion()));
+    }
+}
+
+TEST_CASE("ETA hall call assignment")
+{
+    BuildingGeometry geometry;
+    geometry.MaxFloor = 20;
+
+    ElevatorGroup group(2, geometry);
+    group.SetCostFunction(GroupCostFunction::Eta);
+    group.SetEtaTiming(TEST_TIMING);
+
+    // First car is closer, but goes away to floor 20. Second car is idle
+    group.GetCar(0)->SetCurrentFloor(10, MovementType::Up);
+    group.GetCar(0)->AddPassengerToElevator(20);
+    group.GetCar(1)->SetCurrentFloor(1, MovementType::Up);
+
+    REQUIRE(group.AddPassenger(8, 1) == 1);
+
+    // Call ahead of first car in its direction
+    REQUIRE(group.AddPassenger(15, 18) == 0);
+}
@@ -0,0 +1,73 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "Elevator.h"
+
+namespace
+{
+    BranchAndBoundPolicy MakePlanner(Microseconds budget)
+    {
+        BranchAndBoundPolicy planner;
+        planner.Budget = budget;
+        planner.Timing = { 1000ms, 5000ms };
+        return planner;
+    }
+}
+
+TEST_CASE("Branch and bound route planner")
+{
+    SECTION("Picks up crowd behind before single rider ahead")
+    {
+        Elevator elevator;
+        elevator.SetCurrentFloor(5, MovementType::Up);
+        elevator.AddPassengerToElevator(6);
+
+        for (int i = 0; i < 5; i++)
+            elevator.AddPassenger(4, 1);
+
+        REQUIRE(elevator.GetNextFloor(NearestInDirectionPolicy{}) == 6);
+        REQUIRE(elevator.GetNextFloor(MakePlanner(10ms)) == 4);
+    }
+
+    SECTION("Keeps direction when sweep is optimal")
+    {
+        Elevator elevator;
+        elevator.SetCurrentFloor(5, MovementType::Up);
+        elevator.AddPassengerToElevator(7);
+        elevator.AddPassengerToElevator(9);
+        elevator.AddPassenger(3, 1);
+
+        REQUIRE(elevator.GetNextFloor(MakePlanner(10ms)) == 7);
+    }
+
+    SECTION("Zero budget returns requested floor")
+    {
+        Elevator elevator;
+        elevator.SetCurrentFloor(10, MovementType::Down);
+
+        for (Floor floor = 1; floor < 10; floor++)
+        {
+            elevator.AddPassengerToElevator(floor);
+            elevator.AddPassenger(floor + 10, floor);
+        }
+
+        // No search, first stop of sweep down from floor 10
+        REQUIRE(elevator.GetNextFloor(MakePlanner(0us)) == 9);
+    }
+}
@@ -0,0 +1,100 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "ElevatorGroup.h"
+
+TEST_CASE("Car capacity")
+{
+    SECTION("Passengers over person limit wait on floor")
+    {
+        Elevator elevator;
+        elevator.SetCapacity({ 3, 0 });
+
+        for (int i = 0; i < 5; i++)
+            elevator.AddPassenger(1, 9);
+
+        elevator.ProcessStop();
+
+        REQUIRE(elevator.GetRidingCount() == 3);
+        REQUIRE(elevator.GetWaitingCount() == 2);
+        REQUIRE(elevator.IsFull());
+        REQUIRE(elevator.GetLoad() == 3 * DEFAULT_PASSENGER_MASS);
+    }
+
+    SECTION("Load limit keeps queue order")
+    {
+        Elevator elevator;
+        elevator.SetCapacity({ 0, 200 });
+        elevator.AddPassenger(1, 9, 120);
+        elevator.AddPassenger(1, 9, 90);
+        elevator.AddPassenger(1, 9, 60);
+
+        elevator.ProcessStop();
+
+        // Third passenger fits, but waits behind second
+        REQUIRE(elevator.GetRidingCount() == 1);
+        REQUIRE(elevator.GetLoad() == 120);
+        REQUIRE(elevator.IsFull());
+    }
+
+    SECTION("Passenger heavier than car is rejected")
+    {
+        Elevator elevator;
+        elevator.SetCapacity({ 0, 200 });
+        elevator.AddPassenger(1, 9, 250);
+
+        REQUIRE(elevator.GetWaitingCount() == 0);
+    }
+
+    SECTION("Full car bypasses hall calls until riders exit")
+    {
+        Elevator elevator;
+        elevator.SetCapacity({ 2, 0 });
+        elevator.AddPassenger(1, 9);
+        elevator.AddPassenger(1, 9);
+        elevator.ProcessStop();
+        elevator.AddPassenger(4, 8);
+
+        REQUIRE(elevator.IsFull());
+        REQUIRE(elevator.GetNextFloor() == 9);
+
+        elevator.MoveTo(9);
+        elevator.ProcessStop();
+
+        REQUIRE_FALSE(elevator.IsFull());
+        REQUIRE(elevator.GetLoad() == 0);
+        REQUIRE(elevator.GetNextFloor() == 4);
+    }
+
+    SECTION("Group moves passengers left by full car")
+    {
+        ElevatorGroup group(2);
+        group.SetCapacity({ 2, 0 });
+
+        auto car = group.GetCar(0);
+        for (int i = 0; i < 4; i++)
+            car->AddPassenger(1, 9);
+
+        car->ProcessStop();
+
+        REQUIRE(group.ReassignHallCalls(0) == 1);
+        REQUIRE(car->GetWaitingCount() == 0);
+        REQUIRE(group.GetCar(1)->GetWaitingCount() == 2);
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "Simulation.h"
+
+TEST_CASE("Double-deck car")
+{
+    SECTION("Car stops on lower floor of pair")
+    {
+        Elevator elevator;
+        elevator.SetDoubleDeck(true);
+        elevator.AddPassengerToElevator(6);
+
+        REQUIRE(elevator.GetStopFloor(6) == 5);
+        REQUIRE(elevator.GetStopFloor(5) == 5);
+        REQUIRE(elevator.GetNextFloor() == 5);
+        REQUIRE(elevator.HasStopAt(5));
+    }
+
+    SECTION("Both decks open on stop")
+    {
+        Elevator elevator;
+        elevator.SetDoubleDeck(true);
+        elevator.MoveTo(3);
+        elevator.AddPassenger(3, 9);
+        elevator.AddPassenger(4, 8);
+        elevator.ProcessStop();
+
+        REQUIRE(elevator.GetRidingCount() == 2);
+        REQUIRE(elevator.GetDeckLoad(0) == DEFAULT_PASSENGER_MASS);
+        REQUIRE(elevator.GetDeckLoad(1) == DEFAULT_PASSENGER_MASS);
+
+        elevator.MoveTo(8);
+        REQUIRE(elevator.GetCurrentFloor() == 7);
+
+        elevator.ProcessStop();
+        REQUIRE(elevator.GetRidingCount() == 1);
+        REQUIRE(elevator.GetDeliveredCount() == 1);
+    }
+
+    SECTION("Lobby passengers take deck of destination")
+    {
+        Elevator elevator;
+        elevator.SetDoubleDeck(true);
+        elevator.SetCapacity({ 1, 0 });
+        elevator.AddPassenger(1, 4);
+        elevator.AddPassenger(1, 6);
+        elevator.AddPassenger(1, 5);
+        elevator.ProcessStop();
+
+        // Upper deck takes first passenger, second goes to free lower deck, third waits
+        REQUIRE(elevator.GetRidingCount() == 2);
+        REQUIRE(elevator.GetWaitingCount() == 1);
+        REQUIRE(elevator.IsFull());
+    }
+
+    SECTION("Double-deck cars deliver more passengers in up-peak")
+    {
+        SimulationConfig config;
+        config.Geometry = { 1, 30, 1 };
+        config.CarCount = 2;
+        config.Capacity = { 10, 0 };
+        config.Duration = 1h;
+        config.Seed = 3;
+        config.Traffic.Profile = TrafficProfile::UpPeak;
+        config.Traffic.PassengersPerHour = 1200;
+
+        Simulation single(config);
+        auto singleReport = single.Run();
+
+        config.DoubleDeck = true;
+        Simulation doubleDeck(config);
+        auto doubleReport = doubleDeck.Run();
+
+        REQUIRE(doubleReport.DeliveredCount > singleReport.DeliveredCount);
+    }
+}
@@ -20,148 +20,194 @@
 
 TEST_CASE("Get next floor with default passengers")
 {
+    Elevator elevator;
+
     SECTION("Step 1")
     {
-        sElevator->ResetAllPassengers();
-        sElevator->AddPassenger(4, 2);
-        sElevator->AddPassenger(5, 1);
-        REQUIRE(sElevator->GetNextFloor() == 4);
+        elevator.ResetAllPassengers();
+        elevator.AddPassenger(4, 2);
+        elevator.AddPassenger(5, 1);
+        REQUIRE(elevator.GetNextFloor() == 4);
     }
 
     SECTION("Step 2")
     {
-        sElevator->ResetAllPassengers();
-        sElevator->AddPassenger(3, 9);
-        sElevator->AddPassenger(5, 1);
-        REQUIRE(sElevator->GetNextFloor() == 3);
+        elevator.ResetAllPassengers();
+        elevator.AddPassenger(3, 9);
+        elevator.AddPassenger(5, 1);
+        REQUIRE(elevator.GetNextFloor() == 3);
     }
 
     SECTION("Step 3")
     {
-        sElevator->ResetAllPassengers();
-        sElevator->SetCurrentFloor(1, MovementType::Up);
-        sElevator->AddPassenger(8, 2);
-        sElevator->AddPassenger(6, 2);
+        elevator.ResetAllPassengers();
+        elevator.SetCurrentFloor(1, MovementType::Up);
+        elevator.AddPassenger(8, 2);
+        elevator.AddPassenger(6, 2);
 
-        REQUIRE(sElevator->GetNextFloor() == 6);
+        REQUIRE(elevator.GetNextFloor() == 6);
     }
 
     SECTION("Step 4")
     {
-        sElevator->ResetAllPassengers();
-        sElevator->SetCurrentFloor(1, MovementType::Down);
-        sElevator->AddPassenger(8, 2);
-        sElevator->AddPassenger(6, 2);
+        elevator.ResetAllPassengers();
+        elevator.SetCurrentFloor(1, MovementType::Down);
+        elevator.AddPassenger(8, 2);
+        elevator.AddPassenger(6, 2);
 
-        REQUIRE(sElevator->GetNextFloor() == 6);
+        REQUIRE(elevator.GetNextFloor() == 6);
     }
 
     SECTION("Step 5")
     {
-        sElevator->ResetAllPassengers();
-        sElevator->SetCurrentFloor(9, MovementType::Down);
-        sElevator->AddPassenger(6, 2);
-        sElevator->AddPassenger(8, 2);
-        sElevator->AddPassenger(7, 3);
+        elevator.ResetAllPassengers();
+        elevator.SetCurrentFloor(9, MovementType::Down);
+        elevator.AddPassenger(6, 2);
+        elevator.AddPassenger(8, 2);
+        elevator.AddPassenger(7, 3);
 
-        REQUIRE(sElevator->GetNextFloor() == 8);
+        REQUIRE(elevator.GetNextFloor() == 8);
     }
 
     SECTION("Step 6")
     {
-        sElevator->ResetAllPassengers();
-        sElevator->SetCurrentFloor(9, MovementType::Up);
+        elevator.ResetAllPassengers();
+        elevator.SetCurrentFloor(9, MovementType::Up);
 
-        sElevator->AddPassenger(6, 2);
-        sElevator->AddPassenger(8, 2);
-        sElevator->AddPassenger(1, 5);
+        elevator.AddPassenger(6, 2);
+        elevator.AddPassenger(8, 2);
+        elevator.AddPassenger(1, 5);
 
-        REQUIRE(sElevator->GetNextFloor() == 8);
+        REQUIRE(elevator.GetNextFloor() == 8);
     }
 
     SECTION("Step 7")
     {
-        sElevator->ResetAllPassengers();
-        sElevator->SetCurrentFloor(5, MovementType::Up);
-        sElevator->AddPassenger(3, 1);
-        sElevator->AddPassenger(7, 9);
+        elevator.ResetAllPassengers();
+        elevator.SetCurrentFloor(5, MovementType::Up);
+        elevator.AddPassenger(3, 1);
+        elevator.AddPassenger(7, 9);
 
-        REQUIRE(sElevator->GetNextFloor() == 7);
+        REQUIRE(elevator.GetNextFloor() == 7);
     }
 
     SECTION("Step 8")
     {
-        sElevator->ResetAllPassengers();
-        sElevator->SetCurrentFloor(5, MovementType::Down);
-        sElevator->AddPassenger(3, 1);
-        sElevator->AddPassenger(7, 9);
+        elevator.ResetAllPassengers();
+        elevator.SetCurrentFloor(5, MovementType::Down);
+        elevator.AddPassenger(3, 1);
+        elevator.AddPassenger(7, 9);
 
-        REQUIRE(sElevator->GetNextFloor() == 3);
+        REQUIRE(elevator.GetNextFloor() == 3);
     }
 }
 
 TEST_CASE("Get next floor with elevator passengers")
 {
+    Elevator elevator;
+
     SECTION("Step 1")
     {
-        sElevator->ResetAllPassengers();
-        sElevator->SetCurrentFloor(1, MovementType::Up);
-        sElevator->AddPassengerToElevator(9);
-        sElevator->AddPassengerToElevator(5);
-        REQUIRE(sElevator->GetNextFloor() == 5);
+        elevator.ResetAllPassengers();
+        elevator.SetCurrentFloor(1, MovementType::Up);
+        elevator.AddPassengerToElevator(9);
+        elevator.AddPassengerToElevator(5);
+        REQUIRE(elevator.GetNextFloor() == 5);
     }
 
     SECTION("Step 2")
     {
-        sElevator->ResetAllPassengers();
-        sElevator->SetCurrentFloor(9, MovementType::Down);
-        sElevator->AddPassengerToElevator(5);
-        sElevator->AddPassengerToElevator(7);
-        REQUIRE(sElevator->GetNextFloor() == 7);
+        elevator.ResetAllPassengers();
+        elevator.SetCurrentFloor(9, MovementType::Down);
+        elevator.AddPassengerToElevator(5);
+        elevator.AddPassengerToElevator(7);
+        REQUIRE(elevator.GetNextFloor() == 7);
     }
 
     SECTION("Step 3")
     {
-        sElevator->ResetAllPassengers();
-        sElevator->SetCurrentFloor(9, MovementType::Up);
-        sElevator->AddPassengerToElevator(5);
-        sElevator->AddPassengerToElevator(7);
-        REQUIRE(sElevator->GetNextFloor() == 7);
+        elevator.ResetAllPassengers();
+        elevator.SetCurrentFloor(9, MovementType::Up);
+        elevator.AddPassengerToElevator(5);
+        elevator.AddPassengerToElevator(7);
+        REQUIRE(elevator.GetNextFloor() == 7);
     }
 
     SECTION("Step 4")
     {
-        sElevator->ResetAllPassengers();
-        sElevator->SetCurrentFloor(1, MovementType::Up);
-        sElevator->AddPassengerToElevator(5);
-        sElevator->AddPassengerToElevator(3);
-        REQUIRE(sElevator->GetNextFloor() == 3);
+        elevator.ResetAllPassengers();
+        elevator.SetCurrentFloor(1, MovementType::Up);
+        elevator.AddPassengerToElevator(5);
+        elevator.AddPassengerToElevator(3);
+        REQUIRE(elevator.GetNextFloor() == 3);
     }
 
     SECTION("Step 5")
     {
-        sElevator->ResetAllPassengers();
-        sElevator->SetCurrentFloor(1, MovementType::Down);
-        sElevator->AddPassengerToElevator(5);
-        sElevator->AddPassengerToElevator(3);
-        REQUIRE(sElevator->GetNextFloor() == 3);
+        elevator.ResetAllPassengers();
+        elevator.SetCurrentFloor(1, MovementType::Down);
+        elevator.AddPassengerToElevator(5);
+        elevator.AddPassengerToElevator(3);
+        REQUIRE(elevator.GetNextFloor() == 3);
     }
 
     SECTION("Step 6")
     {
-        sElevator->ResetAllPassengers();
-        sElevator->SetCurrentFloor(5, MovementType::Up);
-        sElevator->AddPassengerToElevator(3);
-        sElevator->AddPassengerToElevator(7);
-        REQUIRE(sElevator->GetNextFloor() == 7);
+        elevator.ResetAllPassengers();
+        elevator.SetCurrentFloor(5, MovementType::Up);
+        elevator.AddPassengerToElevator(3);
+        elevator.AddPassengerToElevator(7);
+        REQUIRE(elevator.GetNextFloor() == 7);
     }
 
     SECTION("Step 7")
     {
-        sElevator->ResetAllPassengers();
-        sElevator->SetCurrentFloor(5, MovementType::Down);
-        sElevator->AddPassengerToElevator(3);
-        sElevator->AddPassengerToElevator(7);
-        REQUIRE(sElevator->GetNextFloor() == 3);
+        elevator.ResetAllPassengers();
+        elevator.SetCurrentFloor(5, MovementType::Down);
+        elevator.AddPassengerToElevator(3);
+        elevator.AddPassengerToElevator(7);
+        REQUIRE(elevator.GetNextFloor() == 3);
+    }
+}
+
+TEST_CASE("Get next floor in tall building with basements")
+{
+    BuildingGeometry geometry;
+    geometry.MinFloor = -5;
+    geometry.MaxFloor = 300;
+    geometry.LobbyFloor = 1;
+
+    Elevator elevator(geometry);
+
+    SECTION("Step 1")
+    {
+        elevator.SetCurrentFloor(1, MovementType::Down);
+        elevator.AddPassenger(-3, 150);
+        elevator.AddPassenger(250, 1);
+        REQUIRE(elevator.GetNextFloor() == -3);
+    }
+
+    SECTION("Step 2")
+    {
+        elevator.SetCurrentFloor(120, MovementType::Up);
+        elevator.AddPassengerToElevator(299);
+        elevator.AddPassengerToElevator(-5);
+        REQUIRE(elevator.GetNextFloor() == 299);
+    }
+
+    SECTION("Step 3")
+    {
+        elevator.SetCurrentFloor(300, MovementType::Up);
+        elevator.AddPassengerToElevator(-5);
+        elevator.AddPassenger(-1, 20);
+        REQUIRE(elevator.GetNextFloor() == -1);
+    }
+
+    SECTION("Step 4")
+    {
+        elevator.SetCurrentFloor(-5, MovementType::Down);
+        elevator.AddPassengerToElevator(-4);
+        elevator.AddPassenger(200, 20);
+        REQUIRE(elevator.GetNextFloor() == -4);
     }
 }
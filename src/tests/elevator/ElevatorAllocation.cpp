@@ -0,0 +1,92 @@
+/*
+* This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+*
+* This program is free software; you can redistribute it and/or modify it
+* under the terms of the GNU Affero General Public License as published by the
+* Free Software Foundation; either version 3 of the License, or (at your
+* option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along
+* with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "catch2/catch.hpp"
+#include "Elevator.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+namespace
+{
+    // Count of global operator new calls in tests binary
+    std::atomic<std::size_t> AllocationCount{};
+}
+
+void* operator new(std::size_t size)
+{
+    AllocationCount++;
+
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+    std::free(ptr);
+}
+
+TEST_CASE("Elevator update loop without allocations")
+{
+    constexpr std::size_t PASSENGERS_MAX = 256;
+    constexpr std::size_t TICK_COUNT = 2000;
+
+    BuildingGeometry geometry;
+    geometry.MinFloor = -2;
+    geometry.MaxFloor = 60;
+
+    Elevator elevator(geometry);
+    elevator.ReservePassengers(PASSENGERS_MAX);
+
+    // Deck assignment runs in same boarding pass
+    elevator.SetDoubleDeck(GENERATE(false, true));
+
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int32> distribution(geometry.MinFloor, geometry.MaxFloor);
+
+    auto runTicks = [&]()
+    {
+        for (std::size_t tick{}; tick < TICK_COUNT; tick++)
+        {
+            if (elevator.GetRidingCount() + elevator.GetWaitingCount() + 2 <= PASSENGERS_MAX)
+            {
+                elevator.AddPassenger(static_cast<Floor>(distribution(generator)), static_cast<Floor>(distribution(generator)));
+                elevator.AddPassengerToElevator(static_cast<Floor>(distribution(generator)));
+            }
+
+            elevator.Update(1s);
+        }
+    };
+
+    // Warm up storage
+    runTicks();
+
+    auto allocations = AllocationCount.load();
+    runTicks();
+
+    REQUIRE(elevator.GetDeliveredCount() > TICK_COUNT);
+    REQUIRE(AllocationCount.load() == allocations);
+}
@@ -0,0 +1,147 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "ElevatorGroup.h"
+#include "Simulation.h"
+
+namespace
+{
+    BuildingGeometry GetZonedGeometry()
+    {
+        return { 1, 60, 1 };
+    }
+
+    std::vector<ElevatorBank> GetZonedBanks()
+    {
+        return *ElevatorBank::Parse("Low:1..20:2;Express:1,40:1;High:21..60:2", GetZonedGeometry());
+    }
+}
+
+TEST_CASE("Elevator banks")
+{
+    SECTION("Parse floors and ranges")
+    {
+        auto banks = GetZonedBanks();
+
+        REQUIRE(banks.size() == 3);
+        REQUIRE(banks[0].Name == "Low");
+        REQUIRE(banks[0].Floors.size() == 20);
+        REQUIRE(banks[1].Floors == std::vector<Floor>{ 1, 40 });
+        REQUIRE(banks[2].CarCount == 2);
+    }
+
+    SECTION("Reject invalid banks")
+    {
+        REQUIRE_FALSE(ElevatorBank::Parse("Low:1..20", GetZonedGeometry()));
+        REQUIRE_FALSE(ElevatorBank::Parse("Low:1..80:2", GetZonedGeometry()));
+        REQUIRE_FALSE(ElevatorBank::Parse("Low:5:2", GetZonedGeometry()));
+        REQUIRE_FALSE(ElevatorBank::Parse("Low:1..20:0", GetZonedGeometry()));
+    }
+
+    SECTION("Car serves only floors of bank")
+    {
+        Elevator elevator(GetZonedGeometry());
+        std::vector<Floor> floors{ 40, 41, 42 };
+        elevator.SetServedFloors(floors);
+
+        REQUIRE(elevator.GetCurrentFloor() == 40);
+
+        elevator.AddPassenger(40, 10);
+        REQUIRE(elevator.GetWaitingCount() == 0);
+
+        elevator.AddPassenger(40, 42);
+        REQUIRE(elevator.GetWaitingCount() == 1);
+    }
+
+    SECTION("Served floors without valid floor are rejected")
+    {
+        Elevator elevator(GetZonedGeometry());
+        std::vector<Floor> floors{ 40, 41, 42 };
+        elevator.SetServedFloors(floors);
+
+        std::vector<Floor> invalidFloors{ 0, 100 };
+        elevator.SetServedFloors(invalidFloors);
+
+        REQUIRE(elevator.GetCurrentFloor() == 40);
+        REQUIRE(elevator.Serves(41));
+        REQUIRE_FALSE(elevator.Serves(10));
+    }
+
+    SECTION("Eligible cars and transfer floor")
+    {
+        ElevatorGroup group(5, GetZonedGeometry());
+        group.SetBanks(GetZonedBanks());
+
+        REQUIRE(group.GetEligibleCars(1, 10) == 0b00011);
+        REQUIRE(group.GetEligibleCars(1, 40) == 0b00100);
+        REQUIRE(group.GetEligibleCars(40, 50) == 0b11000);
+        REQUIRE(group.GetEligibleCars(10, 50) == 0);
+
+        REQUIRE(group.GetLegDestination(1, 10) == 10);
+        REQUIRE(group.GetLegDestination(1, 55) == 40);
+        REQUIRE(group.GetLegDestination(10, 55) == 1);
+        REQUIRE(group.GetLegDestination(40, 55) == 55);
+        REQUIRE(group.GetLegDestination(55, 5) == 40);
+    }
+
+    SECTION("Passenger changes car in sky lobby")
+    {
+        ElevatorGroup group(5, GetZonedGeometry());
+        group.SetBanks(GetZonedBanks());
+
+        auto expressIndex = group.AddPassenger(1, 55);
+        REQUIRE(expressIndex == 2);
+
+        auto express = group.GetCar(expressIndex);
+        express->ProcessStop();
+        express->MoveTo(40);
+        express->ProcessStop();
+
+        REQUIRE(group.ProcessTransfers(expressIndex) == 1);
+        REQUIRE(group.GetDeliveredCount() == 0);
+
+        auto highIndex = group.GetCar(3)->GetWaitingCount() ? 3 : 4;
+        auto high = group.GetCar(highIndex);
+        high->MoveTo(40);
+        high->ProcessStop();
+        high->MoveTo(55);
+        high->ProcessStop();
+
+        REQUIRE(group.GetDeliveredCount() == 1);
+        REQUIRE(group.GetStats().Get(PassengerTimeType::Journey).GetCount() == 1);
+        REQUIRE(group.GetStats().Get(PassengerTimeType::Ride).GetCount() == 2);
+    }
+
+    SECTION("Simulation delivers passengers of all banks")
+    {
+        SimulationConfig config;
+        config.Geometry = GetZonedGeometry();
+        config.Banks = GetZonedBanks();
+        config.CarCount = 5;
+        config.Duration = 2h;
+        config.Seed = 7;
+        config.Traffic.PassengersPerHour = 300;
+
+        Simulation simulation(config);
+        auto report = simulation.Run();
+
+        REQUIRE(report.ArrivedCount > 500);
+        REQUIRE(report.DeliveredCount > report.ArrivedCount * 9 / 10);
+    }
+}
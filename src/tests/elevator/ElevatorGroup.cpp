@@ -0,0 +1,134 @@
+/*
+* This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+*
+* This program is free software; you can redistribute it and/or modify it
+* under the terms of the GNU Affero General Public License as published by the
+* Free Software Foundation; either version 3 of the License, or (at your
+* option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along
+* with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "catch2/catch.hpp"
+#include "ElevatorGroup.h"
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t CAR_COUNT = 4;
+    constexpr std::size_t CALL_COUNT = 40;
+    constexpr std::size_t TICK_COUNT_MAX = 1000;
+
+    std::vector<FloorPassenger> MakeCalls(std::size_t count)
+    {
+        std::mt19937 generator(42);
+        BuildingGeometry const geometry;
+        std::uniform_int_distribution<int32> distribution(geometry.MinFloor, geometry.MaxFloor);
+        std::vector<FloorPassenger> calls;
+
+        while (calls.size() < count)
+        {
+            auto currentFloor = static_cast<Floor>(distribution(generator));
+            auto floorNeed = static_cast<Floor>(distribution(generator));
+            if (currentFloor != floorNeed)
+                calls.emplace_back(currentFloor, floorNeed);
+        }
+
+        return calls;
+    }
+
+    BuildingGeometry GetTallGeometry()
+    {
+        BuildingGeometry geometry;
+        geometry.MaxFloor = 20;
+        return geometry;
+    }
+
+    std::size_t UpdateUntilDelivered(ElevatorGroup& group, std::size_t count)
+    {
+        std::size_t ticks{};
+
+        while (group.GetDeliveredCount() < count && ticks < TICK_COUNT_MAX)
+        {
+            group.Update(1s);
+            ticks++;
+        }
+
+        return ticks;
+    }
+}
+
+TEST_CASE("Elevator group dispatch")
+{
+    SECTION("Every hall call assigned to one car")
+    {
+        ElevatorGroup group(CAR_COUNT);
+
+        for (auto const& call : MakeCalls(20))
+            group.AddPassenger(call.CurrentFloor, call.FloorNeed);
+
+        std::size_t waiting{};
+        for (std::size_t i{}; i < group.GetCarCount(); i++)
+            waiting += group.GetCar(i)->GetWaitingCount();
+
+        REQUIRE(waiting == 20);
+    }
+
+    SECTION("Hall call joins car already stopping at floor")
+    {
+        ElevatorGroup group(CAR_COUNT);
+        group.GetCar(2)->SetCurrentFloor(5, MovementType::Up);
+        group.GetCar(2)->AddPassengerToElevator(7);
+
+        REQUIRE(group.AddPassenger(7, 1) == 2);
+    }
+
+    SECTION("Group delivers passengers faster than isolated cars")
+    {
+        auto calls = MakeCalls(CALL_COUNT);
+
+        ElevatorGroup group(CAR_COUNT);
+        ElevatorGroup isolated(CAR_COUNT);
+
+        for (std::size_t i{}; i < calls.size(); i++)
+        {
+            // Isolated cars: passenger uses the car in front of him
+            isolated.GetCar(i % CAR_COUNT)->AddPassenger(calls[i].CurrentFloor, calls[i].FloorNeed);
+            group.AddPassenger(calls[i].CurrentFloor, calls[i].FloorNeed);
+        }
+
+        auto groupTicks = UpdateUntilDelivered(group, calls.size());
+        auto isolatedTicks = UpdateUntilDelivered(isolated, calls.size());
+
+        REQUIRE(groupTicks < isolatedTicks);
+    }
+
+    SECTION("Destination dispatch groups passengers by destination")
+    {
+        ElevatorGroup group(CAR_COUNT, GetTallGeometry());
+        group.SetAssignmentMode(GroupAssignmentMode::Destination);
+
+        auto firstCar = group.AddPassenger(1, 10);
+        auto secondCar = group.AddPassenger(1, 15);
+
+        REQUIRE(firstCar != secondCar);
+        REQUIRE(group.AddPassenger(1, 10) == firstCar);
+        REQUIRE(group.AddPassenger(1, 15) == secondCar);
+    }
+
+    SECTION("Collective control sends lobby passengers to one car")
+    {
+        ElevatorGroup group(CAR_COUNT, GetTallGeometry());
+
+        auto firstCar = group.AddPassenger(1, 10);
+        REQUIRE(group.AddPassenger(1, 15) == firstCar);
+    }
+}
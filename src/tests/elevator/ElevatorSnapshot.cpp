@@ -0,0 +1,92 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "Elevator.h"
+#include <atomic>
+#include <thread>
+
+TEST_CASE("Elevator snapshot")
+{
+    Elevator elevator({ 1, 20 });
+
+    SECTION("Snapshot stays unchanged after car changes")
+    {
+        elevator.AddPassenger(3, 8);
+        auto snapshot = elevator.GetSnapshot();
+
+        elevator.AddPassenger(5, 1);
+
+        REQUIRE(snapshot->WaitingCount == 1);
+        REQUIRE(snapshot->HasStopAt(2));
+        REQUIRE_FALSE(snapshot->HasStopAt(4));
+        REQUIRE(snapshot->GetDestinationStopDistance(5) == 2u);
+
+        auto current = elevator.GetSnapshot();
+        REQUIRE(current->WaitingCount == 2);
+        REQUIRE(current->HasStopAt(4));
+        REQUIRE(current->Version > snapshot->Version);
+    }
+
+    SECTION("Same snapshot is shared while version is unchanged")
+    {
+        elevator.AddPassenger(3, 8);
+        auto snapshot = elevator.GetSnapshot();
+
+        REQUIRE(elevator.GetSnapshot() == snapshot);
+        REQUIRE(elevator.HasStopAt(3));
+        REQUIRE(elevator.GetSnapshot() == snapshot);
+    }
+
+    SECTION("Reader sees consistent counts while car serves passengers")
+    {
+        constexpr uint32 PASSENGER_COUNT = 2000;
+
+        std::atomic<bool> isDone{};
+        bool isConsistent{ true };
+
+        std::thread reader([&]()
+        {
+            while (!isDone.load(std::memory_order_acquire))
+            {
+                auto snapshot = elevator.GetSnapshot();
+
+                uint32 riders{};
+                uint32 waiting{};
+                for (std::size_t i{}; i < snapshot->Riders.size(); i++)
+                {
+                    riders += snapshot->Riders[i];
+                    waiting += snapshot->WaitingUp[i] + snapshot->WaitingDown[i];
+                }
+
+                isConsistent = isConsistent && riders == snapshot->RidingCount && waiting == snapshot->WaitingCount;
+            }
+        });
+
+        for (uint32 i{}; i < PASSENGER_COUNT; i++)
+        {
+            elevator.AddPassenger(static_cast<Floor>(1 + i % 20), static_cast<Floor>(1 + (i * 7 + 3) % 20));
+            elevator.Update(1s);
+        }
+
+        isDone.store(true, std::memory_order_release);
+        reader.join();
+
+        REQUIRE(isConsistent);
+    }
+}
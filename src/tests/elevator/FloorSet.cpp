@@ -0,0 +1,50 @@
+/*
+* This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+*
+* This program is free software; you can redistribute it and/or modify it
+* under the terms of the GNU Affero General Public License as published by the
+* Free Software Foundation; either version 3 of the License, or (at your
+* option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along
+* with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "catch2/catch.hpp"
+#include "FloorSet.h"
+
+TEST_CASE("Floor set search")
+{
+    FloorSet carCalls(300);
+    FloorSet hallCalls(300);
+
+    SECTION("Empty sets")
+    {
+        REQUIRE(FloorSet::FindNext(0, carCalls, hallCalls) == FloorSet::npos);
+        REQUIRE(FloorSet::FindPrev(299, carCalls, hallCalls) == FloorSet::npos);
+        REQUIRE(FloorSet::FindNext(300, carCalls) == FloorSet::npos);
+        REQUIRE(FloorSet::FindPrev(FloorSet::npos, carCalls) == FloorSet::npos);
+    }
+
+    SECTION("Search across words")
+    {
+        carCalls.Set(3);
+        carCalls.Set(200);
+        hallCalls.Set(64);
+        hallCalls.Set(299);
+
+        REQUIRE(FloorSet::FindNext(4, carCalls, hallCalls) == 64);
+        REQUIRE(FloorSet::FindNext(65, carCalls, hallCalls) == 200);
+        REQUIRE(FloorSet::FindNext(201, carCalls) == FloorSet::npos);
+        REQUIRE(FloorSet::FindNext(201, carCalls, hallCalls) == 299);
+        REQUIRE(FloorSet::FindPrev(199, carCalls, hallCalls) == 64);
+        REQUIRE(FloorSet::FindPrev(63, carCalls, hallCalls) == 3);
+        REQUIRE(FloorSet::FindPrev(2, carCalls, hallCalls) == FloorSet::npos);
+    }
+}
@@ -0,0 +1,203 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "DemandModel.h"
+#include "ElevatorBank.h"
+#include "GroupController.h"
+#include "MotionProfile.h"
+#include "PassengerTrace.h"
+#include <filesystem>
+#include <limits>
+#include <thread>
+
+namespace
+{
+    // Tick cars until all passengers are delivered. Returns false if not delivered in tick count
+    bool DeliverAll(GroupController& controller, std::size_t passengerCount, uint32 tickCount)
+    {
+        for (uint32 i{}; i < tickCount; i++)
+        {
+            controller.Update(1s);
+            controller.Wait();
+
+            if (controller.GetGroup().GetDeliveredCount() == passengerCount)
+                return true;
+        }
+
+        return false;
+    }
+}
+
+TEST_CASE("Group controller")
+{
+    SECTION("Car actors deliver posted hall calls")
+    {
+        constexpr std::size_t PASSENGER_COUNT = 200;
+
+        ElevatorGroup group(4, { 1, 20, 1 });
+        GroupController controller(group);
+
+        for (std::size_t i{}; i < PASSENGER_COUNT; i++)
+            controller.PostPassenger(static_cast<Floor>(1 + i % 20), static_cast<Floor>(1 + (i * 7 + 3) % 20));
+
+        REQUIRE(DeliverAll(controller, PASSENGER_COUNT, 1000));
+
+        std::size_t servingCarCount{};
+        for (std::size_t i{}; i < group.GetCarCount(); i++)
+            servingCarCount += group.GetCar(i)->GetDeliveredCount() != 0;
+
+        REQUIRE(servingCarCount > 1);
+    }
+
+    SECTION("Dispatcher assigns next leg of transfer")
+    {
+        BuildingGeometry geometry{ 1, 60, 1 };
+        ElevatorGroup group(5, geometry);
+        group.SetBanks(*ElevatorBank::Parse("Low:1..20:2;Express:1,40:1;High:21..60:2", geometry));
+
+        GroupController controller(group);
+        controller.PostPassenger(1, 55);
+
+        REQUIRE(DeliverAll(controller, 1, 1000));
+        REQUIRE(group.GetStats().Get(PassengerTimeType::Ride).GetCount() == 2);
+    }
+
+    SECTION("Dispatcher records trace and parks idle cars")
+    {
+        constexpr std::size_t PASSENGER_COUNT = 40;
+
+        auto path = (std::filesystem::temp_directory_path() / "warhead_group_trace_test.bin").string();
+
+        ElevatorGroup group(2, { 1, 20, 1 });
+        DemandModel demandModel(group.GetGeometry());
+        PassengerTraceWriter writer;
+        REQUIRE(writer.Open(path));
+
+        {
+            GroupController controller(group, &demandModel, &writer);
+
+            for (std::size_t i{}; i < PASSENGER_COUNT; i++)
+                controller.PostPassenger(15, 1);
+
+            REQUIRE(DeliverAll(controller, PASSENGER_COUNT, 1000));
+
+            // Idle cars are reported to dispatcher and sent to floor of hall calls
+            for (uint32 i{}; i < 5; i++)
+            {
+                controller.Update(1s);
+                controller.Wait();
+            }
+        }
+
+        REQUIRE(writer.GetRecordCount() == PASSENGER_COUNT);
+        REQUIRE(demandModel.GetArrivalCount() == PASSENGER_COUNT);
+        REQUIRE((group.GetCar(0)->GetCurrentFloor() == 15 || group.GetCar(1)->GetCurrentFloor() == 15));
+
+        writer.Close();
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Dispatcher moves hall calls by reallocation")
+    {
+        CallAllocatorConfig config;
+        config.Interval = 1s;
+        config.Iterations = 1000;
+        config.IsInline = true;
+
+        ElevatorGroup group(2, { 1, 20, 1 });
+        FlightTimeTable const flightTimes(group.GetGeometry(), MotionProfile{});
+        group.SetEtaTiming(flightTimes.GetEtaTiming());
+        group.SetReallocation(config);
+
+        for (std::size_t i{}; i < group.GetCarCount(); i++)
+            group.GetCar(i)->SetFlightTimes(&flightTimes);
+
+        // All hall calls wait first car
+        auto car = group.GetCar(0);
+        for (Floor floor = 5; floor <= 20; floor += 5)
+        {
+            car->AddPassenger(floor, 1);
+            car->AddPassenger(floor, 1);
+        }
+
+        GroupController controller(group);
+
+        // Search started on first tick, its plan is applied on next one
+        for (uint32 i{}; i < 3; i++)
+        {
+            controller.Update(1s);
+            controller.Wait();
+        }
+
+        REQUIRE(group.GetReallocatedCount() > 0);
+        REQUIRE(DeliverAll(controller, 8, 1000));
+    }
+}
+
+TEST_CASE("Actor mailbox")
+{
+    SECTION("Message sent after overflow doesn't pass it")
+    {
+        std::vector<uint32> received;
+        std::atomic<uint32> blockedMessage{ std::numeric_limits<uint32>::max() };
+        std::atomic<uint32> releasedCount{};
+        std::atomic<uint32> receivedCount{};
+
+        auto waitBlocked = [&blockedMessage](uint32 message)
+        {
+            while (blockedMessage.load(std::memory_order_acquire) != message)
+                std::this_thread::yield();
+        };
+
+        {
+            // Handler blocks on first two messages. Cell of message is free only after handler returns
+            Warhead::Actor<uint32> actor(2, [&](uint32 const& message)
+            {
+                if (message < 2)
+                {
+                    blockedMessage.store(message, std::memory_order_release);
+                    while (releasedCount.load(std::memory_order_acquire) <= message)
+                        std::this_thread::yield();
+                }
+
+                received.emplace_back(message);
+                receivedCount.fetch_add(1, std::memory_order_release);
+            });
+
+            actor.Send(0);
+            waitBlocked(0);
+
+            // Second message fills mailbox, third goes to overflow
+            actor.Send(1);
+            actor.Send(2);
+
+            // Cell of first message is free again while overflow waits
+            releasedCount.store(1, std::memory_order_release);
+            waitBlocked(1);
+            actor.Send(3);
+
+            releasedCount.store(2, std::memory_order_release);
+
+            while (receivedCount.load(std::memory_order_acquire) < 4)
+                std::this_thread::yield();
+        }
+
+        REQUIRE(received == std::vector<uint32>{ 0, 1, 2, 3 });
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "ElevatorGroup.h"
+#include "MPSCQueue.h"
+#include <thread>
+#include <vector>
+
+TEST_CASE("Hall call ingress")
+{
+    SECTION("Queue keeps order of every producer")
+    {
+        constexpr uint32 PRODUCER_COUNT = 8;
+        constexpr uint32 PUSH_COUNT = 5000;
+
+        // Value is producer in high bits and push index in low bits
+        Warhead::MPSCQueue<uint64> queue(256);
+        std::vector<std::thread> producers;
+
+        for (uint32 producer{}; producer < PRODUCER_COUNT; producer++)
+        {
+            producers.emplace_back([&queue, producer]()
+            {
+                for (uint32 i{}; i < PUSH_COUNT; i++)
+                    while (!queue.TryPush(uint64(producer) << 32 | i))
+                        std::this_thread::yield();
+            });
+        }
+
+        std::vector<uint32> nextIndexes(PRODUCER_COUNT);
+        uint64 consumedCount{};
+        bool isOrdered{ true };
+
+        while (consumedCount < PRODUCER_COUNT * PUSH_COUNT)
+        {
+            consumedCount += queue.ConsumeAll([&](uint64 value)
+            {
+                auto& nextIndex = nextIndexes[value >> 32];
+                isOrdered = isOrdered && static_cast<uint32>(value) == nextIndex;
+                nextIndex++;
+            });
+        }
+
+        for (auto& thread : producers)
+            thread.join();
+
+        REQUIRE(isOrdered);
+        REQUIRE(queue.Empty());
+    }
+
+    SECTION("Full queue rejects push")
+    {
+        Warhead::MPSCQueue<uint32> queue(3);
+        REQUIRE(queue.GetCapacity() == 4);
+
+        for (uint32 i{}; i < 4; i++)
+            REQUIRE(queue.TryPush(i));
+
+        REQUIRE_FALSE(queue.TryPush(4));
+        REQUIRE(queue.ConsumeAll([](uint32) { }) == 4);
+        REQUIRE(queue.TryPush(4));
+    }
+
+    SECTION("Posted passengers are added by next update")
+    {
+        Elevator elevator;
+        elevator.PostPassenger(5, 9);
+        elevator.PostPassenger(0, 9);
+
+        REQUIRE(elevator.GetWaitingCount() == 0);
+
+        elevator.Update(1s);
+
+        REQUIRE(elevator.GetWaitingCount() == 1);
+    }
+
+    SECTION("Group assigns posted calls in update")
+    {
+        ElevatorGroup group(2);
+        REQUIRE(group.PostPassenger(3, 7));
+
+        group.Update(1s);
+
+        REQUIRE(group.GetCar(0)->GetWaitingCount() + group.GetCar(1)->GetWaitingCount() == 1);
+    }
+}
@@ -0,0 +1,73 @@
+/*
+* This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+*
+* This program is free software; you can redistribute it and/or modify it
+* under the terms of the GNU Affero General Public License as published by the
+* Free Software Foundation; either version 3 of the License, or (at your
+* option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along
+* with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "catch2/catch.hpp"
+#include "PassengerBuckets.h"
+#include <vector>
+
+TEST_CASE("Passenger buckets by floor")
+{
+    PassengerStore store;
+    PassengerBuckets buckets(store);
+    buckets.Resize(100);
+
+    std::vector<PassengerId> ids;
+    for (Floor floorNeed = 1; floorNeed <= 5; floorNeed++)
+        ids.emplace_back(store.Create(1, floorNeed, 0ms));
+
+    buckets.Add(70, ids[0]);
+    buckets.Add(70, ids[1]);
+    buckets.Add(3, ids[2]);
+    buckets.Add(70, ids[3]);
+
+    SECTION("Floors and counts")
+    {
+        REQUIRE(buckets.GetCount() == 4);
+        REQUIRE(buckets.GetCount(70) == 3);
+        REQUIRE(FloorSet::FindNext(4, buckets.GetFloors()) == 70);
+        REQUIRE(FloorSet::FindPrev(69, buckets.GetFloors()) == 3);
+    }
+
+    SECTION("Take keeps arrival order")
+    {
+        std::vector<PassengerId> taken;
+        REQUIRE(buckets.Take(70, 2, [&](PassengerId id) { taken.emplace_back(id); }) == 2);
+        REQUIRE(taken == std::vector<PassengerId>{ ids[0], ids[1] });
+        REQUIRE(buckets.GetFloors().Test(70));
+
+        buckets.Add(70, ids[4]);
+        taken.clear();
+        REQUIRE(buckets.TakeAll(70, [&](PassengerId id) { taken.emplace_back(id); }) == 2);
+        REQUIRE(taken == std::vector<PassengerId>{ ids[3], ids[4] });
+        REQUIRE_FALSE(buckets.GetFloors().Test(70));
+        REQUIRE(buckets.GetCount() == 1);
+    }
+
+    SECTION("Move passenger to another bucket while taking")
+    {
+        PassengerBuckets riders(store);
+        riders.Resize(100);
+
+        buckets.TakeAll(70, [&](PassengerId id) { riders.Add(store.GetDestination(id), id); });
+
+        REQUIRE(riders.GetCount() == 3);
+        REQUIRE(riders.GetCount(1) == 1);
+        REQUIRE(riders.GetCount(4) == 1);
+        REQUIRE(buckets.GetCount() == 1);
+    }
+}
@@ -0,0 +1,142 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "BuildingHost.h"
+#include <atomic>
+#include <thread>
+
+TEST_CASE("Building host")
+{
+    SECTION("Worker with empty queue steals work")
+    {
+        Warhead::WorkStealingPool pool(4);
+        std::atomic<uint32> doneCount{};
+
+        for (uint32 i{}; i < 64; i++)
+        {
+            pool.PostWork(0, [&doneCount]()
+            {
+                std::this_thread::sleep_for(1ms);
+                doneCount.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+
+        pool.Wait();
+
+        REQUIRE(doneCount == 64);
+        REQUIRE(pool.GetStealCount() > 0);
+    }
+
+    SECTION("Only busy buildings are updated")
+    {
+        BuildingHost host(2);
+
+        for (uint32 i{}; i < 8; i++)
+            host.AddBuilding(2, { 1, 20, 1 });
+
+        REQUIRE(host.Update(1s) == 0);
+
+        REQUIRE(host.PostPassenger(3, 2, 15));
+        REQUIRE(host.PostPassenger(5, 18, 1));
+        REQUIRE(host.Update(1s) == 2);
+        host.Wait();
+
+        for (uint32 i{}; i < 100 && host.GetDeliveredCount() < 2; i++)
+        {
+            host.Update(1s);
+            host.Wait();
+        }
+
+        REQUIRE(host.GetDeliveredCount() == 2);
+        REQUIRE(host.GetBuilding(3).GetDeliveredCount() == 1);
+        REQUIRE(host.Update(1s) == 0);
+    }
+
+    SECTION("Idle gap isn't counted in wait time")
+    {
+        BuildingHost host(1);
+        host.AddBuilding(1, { 1, 20, 1 });
+
+        // Idle building gets whole gap with its next update
+        for (uint32 i{}; i < 100; i++)
+            REQUIRE(host.Update(1s) == 0);
+
+        REQUIRE(host.PostPassenger(0, 10, 1));
+
+        for (uint32 i{}; i < 100 && host.GetDeliveredCount() < 1; i++)
+        {
+            host.Update(1s);
+            host.Wait();
+        }
+
+        REQUIRE(host.GetDeliveredCount() == 1);
+        REQUIRE(host.GetStats().Get(PassengerTimeType::Wait).GetMax() < 10000);
+        REQUIRE(host.GetStats().Get(PassengerTimeType::Journey).GetMax() < 10000);
+    }
+
+    SECTION("Post wakes home worker")
+    {
+        Warhead::WorkStealingPool pool(4);
+        std::vector<std::thread::id> threadIds(4);
+
+        // Workers are free, so every work runs on own worker without stealing
+        for (uint32 i{}; i < 4; i++)
+        {
+            pool.PostWork(i, [&threadIds, i]() { threadIds[i] = std::this_thread::get_id(); });
+            pool.Wait();
+        }
+
+        REQUIRE(pool.GetStealCount() == 0);
+        REQUIRE(pool.GetPendingCount() == 0);
+
+        for (uint32 i{}; i < 4; i++)
+        {
+            pool.PostWork(i, [&threadIds, i]() { REQUIRE(threadIds[i] == std::this_thread::get_id()); });
+            pool.Wait();
+        }
+
+        REQUIRE(pool.GetStealCount() == 0);
+    }
+
+    SECTION("Busy worker doesn't delay work of other worker")
+    {
+        Warhead::WorkStealingPool pool(2);
+        std::atomic<bool> isReleased{};
+        std::atomic<bool> isDone{};
+
+        pool.PostWork(0, [&isReleased]()
+        {
+            while (!isReleased.load(std::memory_order_acquire))
+                std::this_thread::yield();
+        });
+
+        pool.PostWork(1, [&isDone]() { isDone.store(true, std::memory_order_release); });
+
+        // Second worker runs own work while first one is busy
+        while (!isDone.load(std::memory_order_acquire))
+            std::this_thread::yield();
+
+        REQUIRE(pool.GetPendingCount() == 1);
+
+        isReleased.store(true, std::memory_order_release);
+        pool.Wait();
+
+        REQUIRE(pool.GetPendingCount() == 0);
+    }
+}
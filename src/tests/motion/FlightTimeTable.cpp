@@ -0,0 +1,79 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "Elevator.h"
+#include "MotionProfile.h"
+
+TEST_CASE("Flight time table")
+{
+    BuildingGeometry const geometry{ 1, 40, 1 };
+    MotionProfile const profile;
+    FlightTimeTable const table(geometry, profile);
+
+    SECTION("Flight time grows with distance")
+    {
+        REQUIRE(table.GetFlightTime(5, 5) == 0ms);
+
+        for (Floor floor = 2; floor < geometry.MaxFloor; floor++)
+            REQUIRE(table.GetFlightTime(1, floor) < table.GetFlightTime(1, floor + 1));
+
+        REQUIRE(table.GetFlightTime(3, 10) == table.GetFlightTime(10, 3));
+    }
+
+    SECTION("Long trip cruises at rated speed")
+    {
+        // Accelerate to 2.5 m/s: 2.5 / 1.0 + 1.0 / 1.5 s, 3.96 m. Same for braking
+        auto const accelerationTime = 2.5 / 1.0 + 1.0 / 1.5;
+        auto const accelerationDistance = 2.5 * accelerationTime / 2.0;
+        auto const seconds = 2.0 * accelerationTime + (39 * 3.5 - 2.0 * accelerationDistance) / 2.5;
+
+        REQUIRE(table.GetFlightTime(1, 40).count() == Approx(seconds * 1000.0).margin(1.0));
+
+        // Every floor of cruise adds floor height at rated speed
+        REQUIRE((table.GetFlightTime(1, 40) - table.GetFlightTime(1, 39)).count() == Approx(1400.0).margin(1.0));
+    }
+
+    SECTION("Lifting heavier side costs energy")
+    {
+        REQUIRE(table.GetEnergy(1, 1, 0) == 0.0);
+
+        // Full car is heavier than counterweight, empty car is lighter
+        REQUIRE(table.GetEnergy(1, 20, 1000) > table.GetEnergy(20, 1, 1000));
+        REQUIRE(table.GetEnergy(20, 1, 0) > table.GetEnergy(1, 20, 0));
+    }
+
+    SECTION("Car flies between floors in updates")
+    {
+        Elevator elevator(geometry);
+        elevator.SetFlightTimes(&table);
+        elevator.AddPassengerToElevator(20);
+
+        elevator.Update(1ms);
+        REQUIRE(elevator.IsTravelling());
+        REQUIRE(elevator.GetCurrentFloor() == 1);
+
+        elevator.Update(table.GetFlightTime(1, 20) - 1ms);
+        REQUIRE(elevator.GetCurrentFloor() == 1);
+
+        elevator.Update(1ms);
+        REQUIRE(elevator.GetCurrentFloor() == 20);
+        REQUIRE(elevator.GetDeliveredCount() == 1);
+        REQUIRE(elevator.GetEnergy() > 0.0);
+    }
+}
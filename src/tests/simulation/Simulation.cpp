@@ -0,0 +1,136 @@
+/*
+* This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+*
+* This program is free software; you can redistribute it and/or modify it
+* under the terms of the GNU Affero General Public License as published by the
+* Free Software Foundation; either version 3 of the License, or (at your
+* option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along
+* with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "catch2/catch.hpp"
+#include "Simulation.h"
+
+namespace
+{
+    SimulationConfig GetTestConfig()
+    {
+        SimulationConfig config;
+        config.Geometry.MinFloor = -2;
+        config.Geometry.MaxFloor = 30;
+        config.Geometry.LobbyFloor = 1;
+        config.CarCount = 4;
+        config.Duration = 2h;
+        config.Traffic.PassengersPerHour = 400;
+        config.Seed = 12345;
+        return config;
+    }
+}
+
+TEST_CASE("Event driven simulation")
+{
+    SECTION("Passengers delivered in virtual time")
+    {
+        Simulation simulation(GetTestConfig());
+        auto report = simulation.Run();
+
+        REQUIRE(report.SimulatedTime == 2h);
+        REQUIRE(report.ArrivedCount > 600);
+        REQUIRE(report.DeliveredCount > report.ArrivedCount - 50);
+        REQUIRE(report.DeliveredCount <= report.ArrivedCount);
+        REQUIRE(report.GetSpeedRatio() > 1.0);
+    }
+
+    SECTION("Same seed gives same result")
+    {
+        Simulation first(GetTestConfig());
+        Simulation second(GetTestConfig());
+
+        auto firstReport = first.Run();
+        auto secondReport = second.Run();
+
+        REQUIRE(firstReport.EventCount == secondReport.EventCount);
+        REQUIRE(firstReport.DeliveredCount == secondReport.DeliveredCount);
+    }
+
+    SECTION("Idle car coroutines wait without events")
+    {
+        auto config = GetTestConfig();
+        config.Traffic.PassengersPerHour = 0;
+        config.CarCount = ElevatorGroup::MAX_CAR_COUNT;
+
+        Simulation simulation(config);
+        auto report = simulation.Run();
+
+        REQUIRE(report.EventCount == 0);
+        REQUIRE(report.DeliveredCount == 0);
+    }
+
+    SECTION("Thousands of car coroutines on one event queue")
+    {
+        auto config = GetTestConfig();
+        config.CarCount = ElevatorGroup::MAX_CAR_COUNT;
+        config.BuildingCount = 64;
+        config.Duration = 30min;
+        config.Traffic.PassengersPerHour = 200;
+
+        Simulation simulation(config);
+        auto report = simulation.Run();
+
+        REQUIRE(simulation.GetBuildingCount() == 64);
+        REQUIRE(report.ArrivedCount > 64 * 50);
+        REQUIRE(report.DeliveredCount > report.ArrivedCount - 64 * 10);
+        REQUIRE(simulation.GetStats().Get(PassengerTimeType::Journey).GetCount() == report.DeliveredCount);
+    }
+
+    SECTION("Buildings on one event queue don't affect each other")
+    {
+        auto config = GetTestConfig();
+        config.Duration = 1h;
+
+        Simulation single(config);
+        auto singleReport = single.Run();
+
+        config.BuildingCount = 8;
+
+        Simulation shared(config);
+        auto sharedReport = shared.Run();
+
+        REQUIRE(sharedReport.DeliveredCount > singleReport.DeliveredCount);
+        REQUIRE(shared.GetGroup(0).GetDeliveredCount() == singleReport.DeliveredCount);
+        REQUIRE(shared.GetGroup(1).GetDeliveredCount() != singleReport.DeliveredCount);
+    }
+}
+
+TEST_CASE("Destination dispatch in up-peak")
+{
+    SimulationConfig config;
+    config.Geometry.MaxFloor = 20;
+    config.CarCount = 4;
+    config.Duration = 2h;
+    config.Traffic.Profile = TrafficProfile::UpPeak;
+    config.Traffic.PassengersPerHour = 1200;
+    config.Seed = 12345;
+
+    Simulation collective(config);
+    auto collectiveReport = collective.Run();
+
+    config.AssignmentMode = GroupAssignmentMode::Destination;
+
+    Simulation destination(config);
+    auto destinationReport = destination.Run();
+
+    auto collectiveJourney = collective.GetGroup().GetStats().Get(PassengerTimeType::Journey).GetMean();
+    auto destinationJourney = destination.GetGroup().GetStats().Get(PassengerTimeType::Journey).GetMean();
+
+    REQUIRE(destinationReport.ArrivedCount == collectiveReport.ArrivedCount);
+    REQUIRE(destinationJourney < collectiveJourney);
+}
@@ -0,0 +1,95 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "SimulationBatch.h"
+
+namespace
+{
+    SimulationBatchConfig GetTestConfig(uint32 threadCount)
+    {
+        SimulationBatchConfig config;
+        config.Base.Geometry.MinFloor = -2;
+        config.Base.Geometry.MaxFloor = 30;
+        config.Base.Geometry.LobbyFloor = 1;
+        config.Base.CarCount = 4;
+        config.Base.Duration = 1h;
+        config.Base.Traffic.PassengersPerHour = 400;
+        config.Base.Seed = 12345;
+        config.RunCount = 12;
+        config.ThreadCount = threadCount;
+        return config;
+    }
+}
+
+TEST_CASE("Simulation batch")
+{
+    SECTION("Totals are sum of runs")
+    {
+        SimulationBatch batch(GetTestConfig(4));
+        auto report = batch.Run();
+
+        REQUIRE(report.Runs.size() == 12);
+
+        uint64 deliveredCount{};
+        uint64 eventCount{};
+
+        for (auto const& run : report.Runs)
+        {
+            REQUIRE(run.SimulatedTime == 1h);
+            REQUIRE(run.DeliveredCount >= report.MinDelivered);
+            REQUIRE(run.DeliveredCount <= report.MaxDelivered);
+            deliveredCount += run.DeliveredCount;
+            eventCount += run.EventCount;
+        }
+
+        REQUIRE(report.SimulatedTime == 12h);
+        REQUIRE(report.DeliveredCount == deliveredCount);
+        REQUIRE(report.EventCount == eventCount);
+        REQUIRE(report.MinDelivered < report.MaxDelivered);
+    }
+
+    SECTION("Result doesn't depend on thread count")
+    {
+        SimulationBatch single(GetTestConfig(1));
+        SimulationBatch parallel(GetTestConfig(8));
+
+        auto singleReport = single.Run();
+        auto parallelReport = parallel.Run();
+
+        REQUIRE(singleReport.ThreadCount == 1);
+
+        for (std::size_t i{}; i < singleReport.Runs.size(); i++)
+        {
+            REQUIRE(singleReport.Runs[i].EventCount == parallelReport.Runs[i].EventCount);
+            REQUIRE(singleReport.Runs[i].DeliveredCount == parallelReport.Runs[i].DeliveredCount);
+        }
+    }
+
+    SECTION("Run options can be changed per run")
+    {
+        SimulationBatch batch(GetTestConfig(4));
+        auto report = batch.Run([](uint32 runIndex, SimulationConfig& config)
+        {
+            config.Traffic.PassengersPerHour = runIndex ? 400 : 0;
+        });
+
+        REQUIRE(report.Runs[0].ArrivedCount == 0);
+        REQUIRE(report.Runs[1].ArrivedCount > 0);
+    }
+}
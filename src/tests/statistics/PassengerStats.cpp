@@ -0,0 +1,118 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "ElevatorGroup.h"
+#include "Random.h"
+
+TEST_CASE("Log-linear histogram")
+{
+    Warhead::LogLinearHistogram histogram;
+
+    SECTION("Small values are exact")
+    {
+        for (uint64 value{}; value < 32; value++)
+            REQUIRE(Warhead::LogLinearHistogram::GetBucketUpperBound(Warhead::LogLinearHistogram::GetBucketIndex(value)) == value);
+    }
+
+    SECTION("Bucket bounds contain value")
+    {
+        Warhead::Xoshiro256 generator(1);
+
+        for (uint32 i{}; i < 10000; i++)
+        {
+            auto value = generator() >> (32 + generator.NextBelow(32));
+            auto index = Warhead::LogLinearHistogram::GetBucketIndex(value);
+
+            REQUIRE(index < Warhead::LogLinearHistogram::BUCKET_COUNT);
+            REQUIRE(Warhead::LogLinearHistogram::GetBucketUpperBound(index) >= value);
+            REQUIRE((index == 0 || Warhead::LogLinearHistogram::GetBucketUpperBound(index - 1) < value));
+        }
+    }
+
+    SECTION("Percentiles within bucket width")
+    {
+        for (uint64 value = 1; value <= 10000; value++)
+            histogram.Add(value);
+
+        REQUIRE(histogram.GetCount() == 10000);
+        REQUIRE(histogram.GetMax() == 10000);
+        REQUIRE(histogram.GetPercentile(100.0) == 10000);
+
+        auto p50 = histogram.GetPercentile(50.0);
+        auto p99 = histogram.GetPercentile(99.0);
+
+        REQUIRE(p50 >= 5000);
+        REQUIRE(p50 <= 5000 + 5000 / 16);
+        REQUIRE(p99 >= 9900);
+        REQUIRE(p99 <= 10000);
+    }
+}
+
+TEST_CASE("Passenger time stats")
+{
+    Elevator elevator;
+
+    // Passenger calls on floor 5 at 10s, car picks him up at 25s and delivers to floor 8 at 40s
+    elevator.SetClock(10s);
+    elevator.AddPassenger(5, 8);
+
+    elevator.SetClock(25s);
+    elevator.MoveTo(5);
+    elevator.ProcessStop();
+
+    elevator.SetClock(40s);
+    elevator.MoveTo(8);
+    elevator.ProcessStop();
+
+    auto const& stats = elevator.GetStats();
+    auto floorIndex = elevator.GetGeometry().GetFloorIndex(5);
+
+    REQUIRE(stats.Get(PassengerTimeType::Wait).GetCount() == 1);
+    REQUIRE(stats.Get(PassengerTimeType::Wait).GetMax() == 15000);
+    REQUIRE(stats.Get(PassengerTimeType::Ride).GetMax() == 15000);
+    REQUIRE(stats.Get(PassengerTimeType::Journey).GetMax() == 30000);
+    REQUIRE(stats.Get(PassengerTimeType::Journey, floorIndex).GetCount() == 1);
+    REQUIRE(stats.Get(PassengerTimeType::Journey, floorIndex + 1).GetCount() == 0);
+}
+
+TEST_CASE("Group merges per floor stats of cars")
+{
+    ElevatorGroup group(2, { 1, 20, 1 });
+
+    for (std::size_t carIndex{}; carIndex < group.GetCarCount(); carIndex++)
+    {
+        auto car = group.GetCar(carIndex);
+        car->AddPassenger(5, 8);
+        car->MoveTo(5);
+        car->ProcessStop();
+        car->MoveTo(8);
+        car->ProcessStop();
+
+        REQUIRE(car->GetStats().GetFloorCount() == 20);
+        REQUIRE(car->GetStats().Get(PassengerTimeType::Journey).GetCount() == 1);
+    }
+
+    auto stats = group.GetStats();
+    auto floorIndex = group.GetGeometry().GetFloorIndex(5);
+
+    REQUIRE(stats.GetFloorCount() == 20);
+    REQUIRE(stats.Get(PassengerTimeType::Journey).GetCount() == 2);
+    REQUIRE(stats.Get(PassengerTimeType::Journey, floorIndex).GetCount() == 2);
+    REQUIRE(stats.Get(PassengerTimeType::Journey, floorIndex + 1).GetCount() == 0);
+}
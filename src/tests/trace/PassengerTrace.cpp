@@ -0,0 +1,224 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "Elevator.h"
+#include "PassengerTrace.h"
+#include "Simulation.h"
+#include <filesystem>
+#include <thread>
+
+namespace
+{
+    std::string GetTracePath(std::string_view name)
+    {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+}
+
+TEST_CASE("Passenger trace")
+{
+    auto path = GetTracePath("warhead_passenger_trace_test.bin");
+
+    SECTION("Elevator passengers recorded and read back")
+    {
+        {
+            PassengerTraceWriter writer;
+            REQUIRE(writer.Open(path));
+
+            Elevator elevator;
+            elevator.SetTraceWriter(&writer);
+
+            elevator.SetClock(1s);
+            elevator.AddPassenger(3, 7);
+            elevator.SetClock(2500ms);
+            elevator.AddPassengerToElevator(5);
+
+            // Invalid passenger is not recorded
+            elevator.AddPassenger(0, 100);
+
+            REQUIRE(writer.GetRecordCount() == 2);
+        }
+
+        PassengerTraceReader reader;
+        REQUIRE(reader.Open(path));
+        REQUIRE(reader.GetRecordCount() == 2);
+
+        std::vector<TrafficArrival> arrivals(16);
+        REQUIRE(reader.Read(arrivals) == 2);
+
+        REQUIRE(arrivals[0].Time == 1s);
+        REQUIRE(arrivals[0].Origin == 3);
+        REQUIRE(arrivals[0].Destination == 7);
+        REQUIRE(arrivals[1].Time == 2500ms);
+        REQUIRE(arrivals[1].Origin == 1);
+        REQUIRE(arrivals[1].Destination == 5);
+
+        REQUIRE(reader.Read(arrivals) == 0);
+    }
+
+    SECTION("Long pause between passengers")
+    {
+        Milliseconds const pause = Milliseconds(std::numeric_limits<uint32>::max()) * 3;
+
+        {
+            PassengerTraceWriter writer;
+            REQUIRE(writer.Open(path));
+            writer.Record(pause, -1, 4);
+        }
+
+        PassengerTraceReader reader;
+        REQUIRE(reader.Open(path));
+
+        std::vector<TrafficArrival> arrivals(1);
+        REQUIRE(reader.Read(arrivals) == 1);
+        REQUIRE(arrivals[0].Time == pause);
+        REQUIRE(arrivals[0].Origin == -1);
+    }
+
+    SECTION("Passenger with same origin and destination replayed")
+    {
+        Milliseconds const pause = Milliseconds(std::numeric_limits<uint32>::max()) + 5s;
+
+        {
+            PassengerTraceWriter writer;
+            REQUIRE(writer.Open(path));
+            writer.Record(1s, 4, 4);
+            writer.Record(pause, 2, 2);
+            REQUIRE(writer.GetRecordCount() == 2);
+        }
+
+        PassengerTraceReader reader;
+        REQUIRE(reader.Open(path));
+
+        // Second passenger needs one time only record before it
+        REQUIRE(reader.GetRecordCount() == 3);
+
+        std::vector<TrafficArrival> arrivals(4);
+        REQUIRE(reader.Read(arrivals) == 2);
+        REQUIRE(arrivals[0].Time == 1s);
+        REQUIRE(arrivals[0].Origin == 4);
+        REQUIRE(arrivals[0].Destination == 4);
+        REQUIRE(arrivals[1].Time == pause);
+        REQUIRE(arrivals[1].Origin == 2);
+        REQUIRE(arrivals[1].Destination == 2);
+    }
+
+    SECTION("Writer shared by threads")
+    {
+        constexpr uint32 THREAD_COUNT = 4;
+        constexpr uint32 RECORD_COUNT = 20000;
+
+        {
+            PassengerTraceWriter writer;
+            REQUIRE(writer.Open(path));
+
+            std::vector<std::thread> threads;
+            for (uint32 thread{}; thread < THREAD_COUNT; thread++)
+                threads.emplace_back([&writer, thread]()
+                {
+                    for (uint32 i{}; i < RECORD_COUNT; i++)
+                        writer.Record(Milliseconds(i), static_cast<Floor>(thread), 9);
+                });
+
+            for (auto& thread : threads)
+                thread.join();
+
+            REQUIRE(writer.GetRecordCount() == THREAD_COUNT * RECORD_COUNT);
+        }
+
+        PassengerTraceReader reader;
+        REQUIRE(reader.Open(path));
+        REQUIRE(reader.GetRecordCount() == THREAD_COUNT * RECORD_COUNT);
+
+        std::vector<TrafficArrival> arrivals(1024);
+        std::size_t count{};
+
+        for (std::size_t read = reader.Read(arrivals); read; read = reader.Read(arrivals))
+        {
+            for (std::size_t i{}; i < read; i++)
+                REQUIRE(arrivals[i].Destination == 9);
+
+            count += read;
+        }
+
+        REQUIRE(count == THREAD_COUNT * RECORD_COUNT);
+    }
+
+    SECTION("Read in small blocks")
+    {
+        {
+            PassengerTraceWriter writer;
+            REQUIRE(writer.Open(path));
+
+            for (uint32 i{}; i < 20000; i++)
+                writer.Record(Milliseconds(i * 10), static_cast<Floor>(1 + i % 9), static_cast<Floor>(1 + (i + 1) % 9));
+        }
+
+        PassengerTraceReader reader;
+        REQUIRE(reader.Open(path));
+
+        std::vector<TrafficArrival> arrivals(7);
+        std::size_t count{};
+
+        for (std::size_t read = reader.Read(arrivals); read; read = reader.Read(arrivals))
+        {
+            for (std::size_t i{}; i < read; i++, count++)
+                REQUIRE(arrivals[i].Time == Milliseconds(count * 10));
+        }
+
+        REQUIRE(count == 20000);
+    }
+
+    SECTION("Simulation replays trace")
+    {
+        SimulationConfig config;
+        config.Duration = 1h;
+        config.Seed = 12345;
+
+        {
+            PassengerTraceWriter writer;
+            REQUIRE(writer.Open(path));
+
+            for (uint32 i{}; i < 100; i++)
+                writer.Record(Milliseconds(i) * 20000, 1, 9);
+        }
+
+        config.ReplayFile = path;
+
+        Simulation simulation(config);
+        auto report = simulation.Run();
+
+        REQUIRE(report.ArrivedCount == 100);
+        REQUIRE(report.DeliveredCount == 100);
+    }
+
+    SECTION("Not trace file")
+    {
+        {
+            std::FILE* file = std::fopen(path.c_str(), "wb");
+            std::fputs("hall calls", file);
+            std::fclose(file);
+        }
+
+        PassengerTraceReader reader;
+        REQUIRE_FALSE(reader.Open(path));
+    }
+
+    std::filesystem::remove(path);
+}
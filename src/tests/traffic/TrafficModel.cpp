@@ -0,0 +1,189 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "TrafficModel.h"
+
+namespace
+{
+    constexpr std::size_t SAMPLE_COUNT = 100000;
+
+    BuildingGeometry GetTestGeometry()
+    {
+        BuildingGeometry geometry;
+        geometry.MinFloor = -2;
+        geometry.MaxFloor = 20;
+        geometry.LobbyFloor = 1;
+        return geometry;
+    }
+
+    std::vector<TrafficArrival> GenerateArrivals(TrafficConfig const& config, uint64 seed = 12345)
+    {
+        TrafficModel model(GetTestGeometry(), config, seed);
+
+        std::vector<TrafficArrival> arrivals(SAMPLE_COUNT);
+        model.Generate(arrivals);
+        return arrivals;
+    }
+}
+
+TEST_CASE("Fast random generator")
+{
+    SECTION("Same seed gives same stream")
+    {
+        Warhead::Xoshiro256 first(42);
+        Warhead::Xoshiro256 second(42);
+
+        uint64 values[64]{};
+        first.Fill(values, 64);
+
+        for (auto value : values)
+            REQUIRE(value == second());
+    }
+
+    SECTION("Jump gives other stream")
+    {
+        Warhead::Xoshiro256 first(42);
+        Warhead::Xoshiro256 second(42);
+        second.Jump();
+
+        REQUIRE(first() != second());
+    }
+
+    SECTION("Bounded values in range")
+    {
+        Warhead::Xoshiro256 generator(7);
+        uint32 counts[10]{};
+
+        for (std::size_t i{}; i < SAMPLE_COUNT; i++)
+            counts[generator.NextBelow(10)]++;
+
+        for (auto count : counts)
+            REQUIRE(count > SAMPLE_COUNT / 10 * 9 / 10);
+    }
+}
+
+TEST_CASE("Traffic models")
+{
+    auto const geometry = GetTestGeometry();
+
+    SECTION("Poisson arrival rate")
+    {
+        TrafficConfig config;
+        config.PassengersPerHour = 3600;
+
+        auto arrivals = GenerateArrivals(config);
+
+        // 3600 per hour is one per second, so average interval is 1000 ms
+        auto averageInterval = static_cast<double>(arrivals.back().Time.count()) / SAMPLE_COUNT;
+        REQUIRE(averageInterval > 980.0);
+        REQUIRE(averageInterval < 1020.0);
+
+        for (std::size_t i = 1; i < arrivals.size(); i++)
+            REQUIRE(arrivals[i].Time >= arrivals[i - 1].Time);
+    }
+
+    SECTION("Uniform trips between valid different floors")
+    {
+        for (auto const& arrival : GenerateArrivals({}))
+        {
+            REQUIRE(geometry.IsValidFloor(arrival.Origin));
+            REQUIRE(geometry.IsValidFloor(arrival.Destination));
+            REQUIRE(arrival.Origin != arrival.Destination);
+        }
+    }
+
+    SECTION("Up-peak trips mostly from lobby")
+    {
+        TrafficConfig config;
+        config.Profile = TrafficProfile::UpPeak;
+
+        std::size_t fromLobby{}, toLobby{};
+
+        for (auto const& arrival : GenerateArrivals(config))
+        {
+            fromLobby += arrival.Origin == geometry.LobbyFloor;
+            toLobby += arrival.Destination == geometry.LobbyFloor;
+        }
+
+        REQUIRE(fromLobby > SAMPLE_COUNT * 83 / 100);
+        REQUIRE(fromLobby < SAMPLE_COUNT * 87 / 100);
+        REQUIRE(toLobby == 0);
+    }
+
+    SECTION("Down-peak trips mostly to lobby")
+    {
+        TrafficConfig config;
+        config.Profile = TrafficProfile::DownPeak;
+
+        std::size_t toLobby{};
+
+        for (auto const& arrival : GenerateArrivals(config))
+        {
+            REQUIRE(arrival.Origin != geometry.LobbyFloor);
+            toLobby += arrival.Destination == geometry.LobbyFloor;
+        }
+
+        REQUIRE(toLobby > SAMPLE_COUNT * 83 / 100);
+    }
+
+    SECTION("Inter floor trips avoid lobby")
+    {
+        TrafficConfig config;
+        config.Profile = TrafficProfile::InterFloor;
+
+        for (auto const& arrival : GenerateArrivals(config))
+        {
+            REQUIRE(arrival.Origin != geometry.LobbyFloor);
+            REQUIRE(arrival.Destination != geometry.LobbyFloor);
+        }
+    }
+
+    SECTION("Origin-destination matrix")
+    {
+        auto const floorCount = geometry.GetFloorCount();
+
+        // Only trips from floor 5 to floor 10 and from floor 10 to floor 5 three times more often
+        TrafficConfig config;
+        config.Profile = TrafficProfile::Matrix;
+        config.Matrix.resize(std::size_t(floorCount) * floorCount);
+        config.Matrix[geometry.GetFloorIndex(5) * floorCount + geometry.GetFloorIndex(10)] = 1.0;
+        config.Matrix[geometry.GetFloorIndex(10) * floorCount + geometry.GetFloorIndex(5)] = 3.0;
+
+        std::size_t fromTen{};
+
+        for (auto const& arrival : GenerateArrivals(config))
+        {
+            REQUIRE((arrival.Origin == 5 || arrival.Origin == 10));
+            REQUIRE(arrival.Destination == (arrival.Origin == 5 ? 10 : 5));
+            fromTen += arrival.Origin == 10;
+        }
+
+        REQUIRE(fromTen > SAMPLE_COUNT * 73 / 100);
+        REQUIRE(fromTen < SAMPLE_COUNT * 77 / 100);
+    }
+
+    SECTION("Building with one floor has no traffic")
+    {
+        BuildingGeometry oneFloor;
+        oneFloor.MaxFloor = oneFloor.MinFloor;
+
+        TrafficModel model(oneFloor, {}, 1);
+        REQUIRE_FALSE(model.IsEnabled());
+    }
+}